@@ -1,5 +1,6 @@
 #include <iostream>
 #include <script/ScriptEngine.h>
+#include <script/OutputSink.h>
 #include "Vec2.h"
 #include "FileObject.h"
 #include <chrono>
@@ -25,10 +26,20 @@ int main()
 	std::string command;
 	while (true)
 	{
-		std::getline(std::cin, command);
+		// the prompt follows the output of the previous command
+		std::cout << ">> " << std::flush;
+		if (!std::getline(std::cin, command))
+			break;
 		try
 		{
-			std::cout << ">> " << engine.execute(command)->toString() << std::endl;
+			// the command may write to the console => execute before the result is printed
+			const auto result = engine.execute(command);
+			// print at most 64k characters of the result
+			script::StreamSink sink(std::cout, 1 << 16);
+			result->writeTo(sink);
+			if (sink.isTruncated())
+				std::cout << "...";
+			std::cout << std::endl;
 		}
 		catch (const std::exception& e)
 		{
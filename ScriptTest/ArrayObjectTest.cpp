@@ -1,4 +1,6 @@
 #include "pch.h"
+#include "script/OutputSink.h"
+#include "script/ThreadPool.h"
 
 #define TestSuite ScriptObjectArrayTest
 using namespace script;
@@ -88,6 +90,25 @@ TEST(TestSuite, Equals)
 	ASSERT_FALSE(arr5->equals(arr1));
 }
 
+TEST(TestSuite, HashCode)
+{
+	auto arr1 = Util::makeArray(1, "a", Util::makeArray(2, 3));
+	auto arr2 = Util::makeArray(1, "a", Util::makeArray(2, 3));
+	ASSERT_TRUE(arr1->equals(arr2));
+	EXPECT_EQ(arr1->hashCode(), arr2->hashCode());
+
+	// slices hash like arrays with the same elements
+	EXPECT_EQ(Util::makeArray(5, 7, 9)->slice(1)->hashCode(), Util::makeArray(7, 9)->hashCode());
+
+	// order matters
+	EXPECT_NE(Util::makeArray(1, 2)->hashCode(), Util::makeArray(2, 1)->hashCode());
+
+	// an array that contains itself terminates
+	auto rec = Util::makeArray(1);
+	rec->add(rec);
+	rec->hashCode();
+}
+
 TEST(TestSuite, AddAll)
 {
 	auto arr1 = Util::makeArray(1, 2, 3);
@@ -98,4 +119,241 @@ TEST(TestSuite, AddAll)
 	// add itself
 	arr1->addAll(arr1);
 	ASSERT_TRUE(arr1->equals(Util::makeArray(1, 2, 3, 4, 5, 1, 2, 3, 4, 5)));
-}
\ No newline at end of file
+}
+
+TEST(TestSuite, SliceCopyOnWrite)
+{
+	auto arr = Util::makeArray(3, 5, 7, 9, 11);
+	auto slice = arr->slice(1, 3);
+	ASSERT_TRUE(slice->equals(Util::makeArray(5, 7, 9)));
+
+	// modifying the slice does not modify the source
+	slice->set(0, Util::makeObject(1));
+	slice->add(Util::makeObject(2));
+	ASSERT_TRUE(slice->equals(Util::makeArray(1, 7, 9, 2)));
+	ASSERT_TRUE(arr->equals(Util::makeArray(3, 5, 7, 9, 11)));
+
+	// modifying the source does not modify the slice
+	slice = arr->slice(2);
+	arr->remove(2);
+	arr->clear();
+	ASSERT_EQ(arr->getCount(), 0);
+	ASSERT_TRUE(slice->equals(Util::makeArray(7, 9, 11)));
+}
+
+TEST(TestSuite, AddAllCopyOnWrite)
+{
+	auto arr1 = Util::makeArray(1, 2, 3);
+	auto arr2 = Util::makeArray();
+	arr2->addAll(arr1);
+	ASSERT_TRUE(arr2->equals(arr1));
+
+	arr2->add(Util::makeObject(4));
+	ASSERT_TRUE(arr1->equals(Util::makeArray(1, 2, 3)));
+	ASSERT_TRUE(arr2->equals(Util::makeArray(1, 2, 3, 4)));
+
+	// add a slice of itself
+	arr1->addAll(arr1->slice(1));
+	ASSERT_TRUE(arr1->equals(Util::makeArray(1, 2, 3, 2, 3)));
+}
+
+TEST(TestSuite, WriteTo)
+{
+	auto arr = Util::makeArray(1, "text", Util::makeArray(2, std::vector<int>{ 3, 4 }));
+	StringSink sink;
+	arr->writeTo(sink);
+	EXPECT_EQ(sink.getString(), arr->toString());
+	EXPECT_EQ(sink.getString(), "[1, \"text\", [2, [3, 4]]]");
+	EXPECT_FALSE(sink.isTruncated());
+
+	// size limit
+	StringSink limited(9);
+	arr->writeTo(limited);
+	EXPECT_EQ(limited.getString(), "[1, \"text");
+	EXPECT_TRUE(limited.isFull());
+	EXPECT_TRUE(limited.isTruncated());
+
+	// limit ends exactly after an element or a separator
+	for (size_t limit : { size_t(2), size_t(4) })
+	{
+		StringSink exact(limit);
+		arr->writeTo(exact);
+		EXPECT_EQ(exact.getString(), sink.getString().substr(0, limit));
+		EXPECT_TRUE(exact.isTruncated());
+	}
+
+	// recursive arrays
+	auto recursive = Util::makeArray(1);
+	recursive->add(recursive);
+	StringSink recursiveSink;
+	recursive->writeTo(recursiveSink);
+	EXPECT_EQ(recursiveSink.getString(), "[1, [...]]");
+	recursive->clear();
+}
+
+TEST(TestSuite, Sort)
+{
+	auto ints = Util::makeArray(3, 1, 2, 1);
+	ints->sort();
+	EXPECT_EQ(ints->toString(), "[1, 1, 2, 3]");
+
+	auto strings = Util::makeArray("b", "c", "a");
+	strings->sort();
+	EXPECT_EQ(strings->toString(), "[\"a\", \"b\", \"c\"]");
+
+	// ints and floats are compared by value
+	auto numbers = Util::makeArray(3, 1.5f, 1);
+	numbers->sort();
+	EXPECT_TRUE(numbers->equals(Util::makeArray(1, 1.5f, 3)));
+
+	// a sorted slice does not modify the original array
+	auto original = Util::makeArray(4, 3, 2, 1);
+	auto slice = original->slice(1);
+	slice->sort();
+	EXPECT_EQ(slice->toString(), "[1, 2, 3]");
+	EXPECT_EQ(original->toString(), "[4, 3, 2, 1]");
+
+	// not comparable
+	auto mixed = Util::makeArray(1, "a");
+	EXPECT_THROW(mixed->sort(), std::runtime_error);
+	EXPECT_EQ(mixed->toString(), "[1, \"a\"]");
+
+	// parallel sort on the current pool (sequential without a pool)
+	const int count = int(ArrayObject::ParallelSortThreshold) * 2;
+	ThreadPool pool(4);
+	for (auto current : { static_cast<ThreadPool*>(nullptr), &pool })
+	{
+		const ThreadPool::Scope scope(current);
+		auto large = std::make_shared<ArrayObject>();
+		for (int i = 0; i < count; ++i)
+			large->add(Util::makeObject((i * 7919) % count));
+		large->sort();
+		for (int i = 0; i < count; ++i)
+			ASSERT_EQ(Util::fromObject<int>(large->get(i)), i);
+	}
+}
+
+TEST(TestSuite, SortBy)
+{
+	// stable: arrays with the same count keep their order
+	auto arrays = Util::makeArray(Util::makeArray(1, 2), Util::makeArray(3), Util::makeArray(4, 5), Util::makeArray());
+	arrays->sortBy("Count");
+	EXPECT_EQ(arrays->toString(), "[[], [3], [1, 2], [4, 5]]");
+
+	ScriptEngine engine;
+	engine.execute("s = [\"ccc\", \"a\", \"bb\"]");
+	engine.execute("s.sortBy(\"Length\")");
+	EXPECT_EQ(engine.execute("s")->toString(), "[\"a\", \"bb\", \"ccc\"]");
+}
+
+TEST(TestSuite, CompareTo)
+{
+	// objects that implement the comparison protocol
+	class Version : public ScriptObject
+	{
+	public:
+		explicit Version(int value) : m_value(value)
+		{
+			addFunction("compareTo", Util::fromLambda([this](const ScriptPtr<Version>& other)
+			{
+				return m_value - other->m_value;
+			}, "int Version::compareTo(Version)"));
+		}
+		int m_value;
+	};
+
+	auto arr = Util::makeArray(std::make_shared<Version>(3), std::make_shared<Version>(1), std::make_shared<Version>(2));
+	arr->sort();
+	for (int i = 0; i < 3; ++i)
+		EXPECT_EQ(std::dynamic_pointer_cast<Version>(arr->get(i))->m_value, i + 1);
+
+	EXPECT_EQ(arr->binarySearch(std::make_shared<Version>(2)), 1);
+	EXPECT_EQ(arr->binarySearch(std::make_shared<Version>(4)), -4);
+}
+
+TEST(TestSuite, Search)
+{
+	auto arr = Util::makeArray(1, "a", Util::makeArray(2), 1);
+	EXPECT_EQ(arr->indexOf(Util::makeObject(1)), 0);
+	EXPECT_EQ(arr->indexOf(Util::makeObject("a")), 1);
+	EXPECT_EQ(arr->indexOf(Util::makeArray(2)), 2);
+	EXPECT_EQ(arr->indexOf(Util::makeObject(2)), -1);
+	EXPECT_TRUE(arr->contains(Util::makeObject("a")));
+	EXPECT_FALSE(arr->contains(Util::makeObject("b")));
+
+	auto sorted = Util::makeArray(1, 3, 5, 7);
+	EXPECT_EQ(sorted->binarySearch(Util::makeObject(5)), 2);
+	EXPECT_EQ(sorted->binarySearch(Util::makeObject(0)), -1);
+	EXPECT_EQ(sorted->binarySearch(Util::makeObject(4)), -3);
+	EXPECT_EQ(sorted->binarySearch(Util::makeObject(8)), -5);
+
+	ScriptEngine engine;
+	engine.execute("a = [5, 2, 9]");
+	EXPECT_EQ(engine.execute("a.indexOf(9)")->toString(), "2");
+	EXPECT_EQ(engine.execute("a.sort().binarySearch(5)")->toString(), "1");
+	EXPECT_EQ(engine.execute("a.contains(3)")->toString(), "false");
+}
+
+TEST(TestSuite, InvokeAll)
+{
+	auto arr = Util::makeArray(1, 2, 3);
+	arr->invokeAll("add", Util::makeArray(2));
+	EXPECT_EQ(arr->toString(), "[3, 4, 5]");
+	EXPECT_EQ(arr->mapInvoke("toString", Util::makeArray())->toString(), "[\"3\", \"4\", \"5\"]");
+
+	// the functions are verified before the first call
+	auto mixed = Util::makeArray(1, "a");
+	EXPECT_THROW(mixed->invokeAll("negate", Util::makeArray()), InvalidFunctionName);
+	EXPECT_EQ(mixed->toString(), "[1, \"a\"]");
+
+	ScriptEngine engine;
+	engine.execute("a = [1, 2, 3]");
+	engine.execute("a.invokeAll(\"multiply\", 3)");
+	EXPECT_EQ(engine.execute("a")->toString(), "[3, 6, 9]");
+	EXPECT_EQ(engine.execute("a.mapInvoke(\"equals\", 6)")->toString(), "[false, true, false]");
+}
+
+TEST(TestSuite, Parallel)
+{
+	ThreadPool pool(4);
+	const int count = int(ArrayObject::ParallelGrainSize) * 10;
+	auto arr = std::make_shared<ArrayObject>();
+	for (int i = 0; i < count; ++i)
+		arr->add(Util::makeObject(i));
+
+	// add is pure
+	EXPECT_TRUE(arr->get(0)->isPure("add"));
+	arr->parallelInvokeAll("add", Util::makeArray(1), &pool);
+	for (int i = 0; i < count; ++i)
+		ASSERT_EQ(Util::fromObject<int>(arr->get(i)), i + 1);
+
+	const auto lengths = arr->parallelMap("toString", Util::makeArray(), &pool);
+	EXPECT_EQ(lengths->getCount(), count);
+	EXPECT_EQ(Util::getBareString(lengths->get(count - 1)), std::to_string(count));
+
+	// the elements are not modified
+	const long long sum = (long long)count * (count + 1) / 2;
+	EXPECT_EQ(Util::fromObject<int>(arr->parallelReduce("add", &pool)), int(sum));
+	EXPECT_EQ(Util::fromObject<int>(arr->get(0)), 1);
+	EXPECT_THROW(std::make_shared<ArrayObject>()->parallelReduce("add", &pool), std::runtime_error);
+
+	// the same object twice => sequential
+	auto same = Util::makeObject(0);
+	auto twice = Util::makeArray(same, same);
+	twice->parallelInvokeAll("add", Util::makeArray(1), &pool);
+	EXPECT_EQ(same->toString(), "2");
+
+	// an element is an argument => sequential (element 0 is modified before the others read it)
+	auto ones = std::make_shared<ArrayObject>();
+	for (int i = 0; i < count; ++i)
+		ones->add(Util::makeObject(1));
+	ones->parallelInvokeAll("add", Util::makeArray(ones->get(0)), &pool);
+	EXPECT_EQ(Util::fromObject<int>(ones->get(0)), 2);
+	for (int i = 1; i < count; ++i)
+		ASSERT_EQ(Util::fromObject<int>(ones->get(i)), 3);
+
+	ScriptEngine engine;
+	engine.setObject("a", arr);
+	EXPECT_EQ(engine.execute("a.parallelInvokeAll(\"multiply\", 2).get(1)")->toString(), "4");
+	EXPECT_EQ(engine.execute("a.slice(0, 3).parallelReduce(\"add\")")->toString(), "12");
+}
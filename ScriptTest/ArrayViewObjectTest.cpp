@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "script/objects/ArrayViewObject.h"
+#include "script/objects/FloatArrayObject.h"
+
+#define TestSuite ArrayViewObjectTest
+using namespace script;
+
+TEST(TestSuite, PinnedVector)
+{
+	auto vec = std::make_shared<std::vector<float>>(std::vector<float>{ 1.0f, 2.0f, 3.0f });
+	auto view = FloatArrayViewObject::pin(vec, true);
+	// no copy
+	EXPECT_EQ(view->data(), vec->data());
+	EXPECT_EQ(view->getCount(), 3);
+
+	view->set(1, 5.0f);
+	EXPECT_EQ((*vec)[1], 5.0f);
+	EXPECT_THROW(view->get(3), std::out_of_range);
+
+	// view keeps the vector alive
+	std::weak_ptr<std::vector<float>> weak = vec;
+	vec.reset();
+	EXPECT_FALSE(weak.expired());
+	EXPECT_EQ(view->get(2), 3.0f);
+	view.reset();
+	EXPECT_TRUE(weak.expired());
+}
+
+TEST(TestSuite, BorrowedMemory)
+{
+	std::vector<int> host = { 4, 8, 15, 16, 23, 42 };
+	auto view = IntArrayViewObject::borrow(static_cast<const int*>(host.data()), host.size());
+	EXPECT_FALSE(view->isWritable());
+	EXPECT_THROW(view->set(0, 1), std::runtime_error);
+
+	auto slice = view->slice(2, 3);
+	EXPECT_EQ(slice->data(), host.data() + 2);
+	EXPECT_EQ(slice->getSum(), 15 + 16 + 23);
+	EXPECT_EQ(view->getMax(), 42);
+	EXPECT_TRUE(view->equals(IntArrayViewObject::pin(std::make_shared<std::vector<int>>(host))));
+	// equals is symmetric: views are only equal to views
+	EXPECT_FALSE(view->equals(Util::makeObject(host)));
+	EXPECT_FALSE(Util::makeObject(host)->equals(view));
+	EXPECT_TRUE(view->copy()->equals(Util::makeObject(host)));
+
+	auto copy = view->clone();
+	auto nested = slice->slice(1, 1);
+	// releasing a slice does not release its parent or its siblings
+	auto sibling = view->slice(0, 2);
+	auto released = view->slice(1, 2);
+	released->release();
+	EXPECT_FALSE(released->isValid());
+	EXPECT_TRUE(view->isValid());
+	EXPECT_TRUE(sibling->isValid());
+	EXPECT_EQ(sibling->getSum(), 4 + 8);
+
+	view->release();
+	EXPECT_FALSE(view->isValid());
+	EXPECT_EQ(view->getCount(), 0);
+	EXPECT_THROW(view->get(0), std::runtime_error);
+	// the slices are released with the view
+	EXPECT_FALSE(slice->isValid());
+	EXPECT_FALSE(nested->isValid());
+	EXPECT_FALSE(sibling->isValid());
+	EXPECT_EQ(slice->data(), nullptr);
+	EXPECT_THROW(slice->getSum(), std::runtime_error);
+	EXPECT_EQ(nested->toString(), "released view");
+	EXPECT_EQ(copy->toString(), "[4, 8, 15, 16, 23, 42]");
+}
+
+TEST(TestSuite, EmptyView)
+{
+	auto view = IntArrayViewObject::pin(std::make_shared<std::vector<int>>());
+	EXPECT_TRUE(view->isValid());
+	EXPECT_EQ(view->toString(), "[]");
+	EXPECT_EQ(view->getSum(), 0);
+	view->release();
+	EXPECT_FALSE(view->isValid());
+}
+
+TEST(TestSuite, ScriptInterface)
+{
+	std::vector<float> host(1000, 0.5f);
+	ScriptEngine engine;
+	engine.setObject("v", FloatArrayViewObject::borrow(host.data(), host.size(), true));
+	EXPECT_EQ(engine.execute("v.getCount()")->toString(), "1000");
+	engine.execute("v.set(10, 2.0f)");
+	EXPECT_EQ(host[10], 2.0f);
+	EXPECT_TRUE(engine.execute("v.getSum()")->equals(Util::makeObject(501.5f)));
+	EXPECT_TRUE(engine.execute("v.slice(9, 2).copy()")->equals(Util::makeObject(std::vector<float>{ 0.5f, 2.0f })));
+	EXPECT_THROW(engine.execute("v.set(0, 1)"), std::runtime_error);
+}
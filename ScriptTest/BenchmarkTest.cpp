@@ -0,0 +1,239 @@
+#include "pch.h"
+#include <chrono>
+#include <iostream>
+#include "script/objects/FloatArrayObject.h"
+#include "script/objects/FloatObject.h"
+#include "script/objects/SetObject.h"
+#include "script/NumericKernels.h"
+
+// the benchmarks are disabled by default. Run with --gtest_also_run_disabled_tests --gtest_filter=BenchmarkTest.*
+#define TestSuite BenchmarkTest
+using namespace script;
+
+namespace
+{
+	// returns the average duration of func in microseconds
+	template<class TFunc>
+	double measure(TFunc func, int iterations)
+	{
+		func(); // warm up
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < iterations; ++i)
+			func();
+		const auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+	}
+
+	void report(const std::string& name, double microseconds)
+	{
+		std::cout << "[ BENCH    ] " << name << ": " << microseconds << " us\n";
+	}
+}
+
+TEST(TestSuite, DISABLED_ElementWiseMultiplyAdd)
+{
+	const int count = 100000;
+	const int iterations = 20;
+
+	// per object path: ArrayObject with one FloatObject per element
+	auto objects = std::make_shared<ArrayObject>();
+	std::vector<float> values;
+	for (int i = 0; i < count; ++i)
+	{
+		objects->add(std::make_shared<FloatObject>(float(i)));
+		values.push_back(float(i));
+	}
+
+	const auto mulArgs = Util::makeArray(1.0001f);
+	const auto addArgs = Util::makeArray(0.5f);
+	report("ArrayObject multiply/add per element", measure([&]()
+	{
+		for (int i = 0; i < objects->getCount(); ++i)
+		{
+			const auto& obj = objects->get(i);
+			obj->invoke("multiply", mulArgs);
+			obj->invoke("add", addArgs);
+		}
+	}, iterations));
+
+	FloatArrayObject floats(values);
+	const auto supported = kernels::getSupportedInstructionSet();
+	const char* names[] = { "Scalar", "SSE4.1", "AVX2" };
+	for (auto set : { kernels::InstructionSet::Scalar, kernels::InstructionSet::SSE41, kernels::InstructionSet::AVX2 })
+	{
+		if (int(set) > int(supported)) break;
+		kernels::setInstructionSet(set);
+
+		report(std::string("FloatArray multiplyEach/addEach ") + names[int(set)], measure([&]()
+		{
+			floats.multiplyEach(1.0001f);
+			floats.addEach(0.5f);
+		}, iterations));
+
+		report(std::string("FloatArray multiplyAddEach ") + names[int(set)], measure([&]()
+		{
+			floats.multiplyAddEach(1.0001f, 0.5f);
+		}, iterations));
+	}
+	kernels::setInstructionSet(supported);
+
+	// script invocation of the whole array operation
+	ScriptEngine engine;
+	engine.setObject("f", std::make_shared<FloatArrayObject>(values));
+	report("script f.multiplyAddEach", measure([&]()
+	{
+		engine.execute("f.multiplyAddEach(1.0001f, 0.5f)");
+	}, iterations));
+}
+
+TEST(TestSuite, DISABLED_StringAppend)
+{
+	// 100k appends of 100 characters => 10 MB
+	const int count = 100000;
+	const std::string chunk(100, 'x');
+
+	// copying the whole string on every append is quadratic => measured with fewer appends
+	const int copyCount = count / 10;
+	report("std::string copy per append (1 MB)", measure([&]()
+	{
+		std::string s;
+		for (int i = 0; i < copyCount; ++i)
+		{
+			std::string next;
+			next.reserve(s.size() + chunk.size());
+			next += s;
+			next += chunk;
+			s = std::move(next);
+		}
+	}, 1));
+
+	const auto scriptAppend = [&chunk](int n, const char* name)
+	{
+		ScriptEngine engine;
+		engine.setObject("x", Util::makeObject(chunk));
+		engine.execute("s = \"\"");
+		const auto start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < n; ++i)
+			engine.execute("s = s + x");
+		const auto end = std::chrono::high_resolution_clock::now();
+		const auto duration = std::chrono::duration<double, std::micro>(end - start).count();
+		report(name, duration);
+
+		EXPECT_EQ(engine.execute("s.getLength()")->toString(), std::to_string(n * chunk.size()));
+		return duration;
+	};
+	const auto small = scriptAppend(copyCount, "script s = s + x (1 MB)");
+	const auto large = scriptAppend(count, "script s = s + x (10 MB)");
+	// linear: ~10x the time for 10x the appends. Copying the string per append would take ~100x
+	EXPECT_LT(large, 30.0 * small);
+}
+
+TEST(TestSuite, DISABLED_SetIntersection)
+{
+	// array scan emulation is quadratic => measured with fewer elements
+	const int scanCount = 10000;
+	const int count = 1000000;
+
+	auto makeIds = [](int n, int offset)
+	{
+		std::vector<int> res;
+		res.reserve(n);
+		for (int i = 0; i < n; ++i)
+			res.push_back(int((i * 7919ll + offset) % (2 * n)));
+		return res;
+	};
+
+	auto makeArray = [](const std::vector<int>& ids)
+	{
+		auto res = std::make_shared<ArrayObject>();
+		for (int id : ids)
+			res->add(Util::makeObject(id));
+		return res;
+	};
+	const std::shared_ptr<const ArrayObject> left = makeArray(makeIds(scanCount, 0));
+	const std::shared_ptr<const ArrayObject> right = makeArray(makeIds(scanCount, 1));
+	report("ArrayObject intersection scan (10k)", measure([&]()
+	{
+		auto res = std::make_shared<ArrayObject>();
+		for (const auto& l : *left)
+			for (const auto& r : *right)
+				if (l->equals(r))
+				{
+					res->add(l);
+					break;
+				}
+	}, 1));
+
+	const SetObject a(makeIds(count, 0));
+	const SetObject b(makeIds(count, 1));
+	report("SetObject getIntersection flat (1M)", measure([&]()
+	{
+		a.getIntersection(b);
+	}, 10));
+
+	SetObject c(*Util::makeArray("x"));
+	c.remove(Util::makeObject("x"));
+	for (int v : makeIds(count, 0))
+		c.add(Util::makeObject(v));
+	report("SetObject getIntersection generic (1M)", measure([&]()
+	{
+		c.getIntersection(b);
+	}, 1));
+}
+
+TEST(TestSuite, DISABLED_Fork)
+{
+	const int iterations = 1000;
+
+	const auto construct = measure([]()
+	{
+		ScriptEngine engine;
+	}, iterations);
+
+	ScriptEngine prototype;
+	prototype.execute("config = [1, 2, 3]");
+	prototype.freeze();
+	const auto fork = measure([&prototype]()
+	{
+		auto engine = prototype.fork();
+	}, iterations);
+
+	report("new ScriptEngine", construct);
+	report("ScriptEngine::fork", fork);
+}
+
+TEST(TestSuite, DISABLED_StepCounter)
+{
+	const int iterations = 200;
+	std::string command = "x = 1";
+	for (int i = 0; i < 999; ++i)
+		command += " + 1";
+
+	// 999 operators per command
+	ScriptEngine engine;
+	const auto compiled = engine.compile(command);
+	const auto unlimited = measure([&]()
+	{
+		engine.execute(compiled);
+	}, iterations);
+
+	// reads the clock every StepCheckInterval steps
+	engine.setStepLimit(ScriptEngine::NoStepLimit - 1);
+	engine.setDeadline(std::chrono::steady_clock::now() + std::chrono::hours(1));
+	const auto limited = measure([&]()
+	{
+		engine.execute(compiled);
+	}, iterations);
+
+	// the counter without the execution of the tokens
+	engine.resetLimits();
+	const auto steps = measure([&]()
+	{
+		for (int i = 0; i < 999; ++i)
+			engine.step();
+	}, iterations);
+
+	report("999 operators", unlimited);
+	report("999 operators with step limit and deadline", limited);
+	report("999 ScriptEngine::step", steps);
+}
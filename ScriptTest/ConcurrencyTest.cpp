@@ -0,0 +1,133 @@
+#include "pch.h"
+#include <thread>
+#include <atomic>
+#include "script/RecursionGuard.h"
+
+#define TestSuite ConcurrencyTest
+using namespace script;
+
+namespace
+{
+	constexpr int ThreadCount = 8;
+
+	template<class TFunc>
+	void runThreads(TFunc func)
+	{
+		std::vector<std::thread> threads;
+		for (int t = 0; t < ThreadCount; ++t)
+			threads.emplace_back(func, t);
+		for (auto& t : threads)
+			t.join();
+	}
+}
+
+TEST(TestSuite, RecursionGuard)
+{
+	const int a = 0, b = 0;
+	const RecursionGuard outer(&a, RecursionGuard::Operation::ToString);
+	EXPECT_FALSE(outer.isRecursive());
+	{
+		const RecursionGuard inner(&a, RecursionGuard::Operation::ToString);
+		EXPECT_TRUE(inner.isRecursive());
+		EXPECT_FALSE(RecursionGuard(&a, RecursionGuard::Operation::HashCode).isRecursive());
+		EXPECT_FALSE(RecursionGuard(&b, RecursionGuard::Operation::ToString).isRecursive());
+	}
+
+	// other threads are not affected
+	bool recursive = true;
+	std::thread([&]() { recursive = RecursionGuard(&a, RecursionGuard::Operation::ToString).isRecursive(); }).join();
+	EXPECT_FALSE(recursive);
+}
+
+TEST(TestSuite, StressVariables)
+{
+	ScriptEngine engine(ScriptEngine::All, ScriptEngine::Threading::Concurrent);
+	EXPECT_TRUE(engine.isConcurrent());
+	constexpr int Iterations = 1000;
+
+	std::atomic<bool> failed = false;
+	runThreads([&](int t)
+	{
+		const auto counter = "counter" + std::to_string(t);
+		try
+		{
+			engine.execute(counter + " = 0");
+			for (int i = 0; i < Iterations; ++i)
+			{
+				// own variable, shared variable and static functions
+				engine.execute(counter + " = " + counter + " + Int(1)");
+				engine.execute("shared = Float(" + std::to_string(i) + ")");
+				engine.execute("shared.toString()");
+				engine.execute("temp" + std::to_string(i % 50) + " = Range(0, 3).sum()");
+				if (i % 100 == 0)
+					engine.getObjects();
+			}
+		}
+		catch (const std::exception&)
+		{
+			failed = true;
+		}
+	});
+
+	EXPECT_FALSE(failed);
+	for (int t = 0; t < ThreadCount; ++t)
+		EXPECT_EQ(engine.execute("counter" + std::to_string(t))->toString(), std::to_string(Iterations));
+	EXPECT_EQ(engine.getObjects().size(), size_t(ThreadCount + 1 + 50));
+
+	engine.clearObjects();
+	EXPECT_EQ(engine.getObjects().size(), size_t(0));
+}
+
+TEST(TestSuite, StressStatics)
+{
+	// readers see consistent snapshots while statics are added
+	ScriptEngine engine(ScriptEngine::All, ScriptEngine::Threading::Concurrent);
+	const auto initial = engine.getStaticObjects()->size();
+	constexpr int Additions = 500;
+
+	std::atomic<bool> failed = false;
+	runThreads([&](int t)
+	{
+		for (int i = 0; i < Additions; ++i)
+		{
+			if (t == 0)
+			{
+				engine.setStaticObject("Value" + std::to_string(i), Util::makeObject(i));
+				continue;
+			}
+			if (!engine.getStaticObject("System") || !engine.getStaticFunction("Int"))
+				failed = true;
+			if (engine.execute("Int(" + std::to_string(i) + ")")->toString() != std::to_string(i))
+				failed = true;
+			const auto objects = engine.getStaticObjects();
+			if (objects->size() < initial || objects->size() > initial + Additions)
+				failed = true;
+		}
+	});
+
+	EXPECT_FALSE(failed);
+	EXPECT_EQ(engine.getStaticObjects()->size(), initial + Additions);
+	EXPECT_EQ(engine.execute("Value42")->toString(), "42");
+}
+
+TEST(TestSuite, SharedRecursiveToString)
+{
+	// several threads print the same self containing array
+	auto array = Util::makeArray(1, 2);
+	array->add(array);
+	const auto expected = array->toString();
+	EXPECT_EQ(expected, "[1, 2, [...]]");
+	const auto hash = array->hashCode();
+
+	std::atomic<bool> failed = false;
+	runThreads([&](int)
+	{
+		for (int i = 0; i < 2000; ++i)
+			if (array->toString() != expected || array->hashCode() != hash)
+				failed = true;
+	});
+	EXPECT_FALSE(failed);
+
+	// break the cycle
+	array->clear();
+}
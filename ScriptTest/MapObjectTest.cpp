@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "script/objects/MapObject.h"
+
+#define TestSuite MapObjectTest
+using namespace script;
+
+TEST(TestSuite, ValueKeys)
+{
+	auto map = std::make_shared<MapObject>();
+	map->set(Util::makeObject(1), Util::makeObject("int"));
+	map->set(Util::makeObject(1.0f), Util::makeObject("float"));
+	map->set(Util::makeObject("1"), Util::makeObject("string"));
+	map->set(Util::makeObject(true), Util::makeObject("bool"));
+	map->set(Util::makeArray(1, 2), Util::makeObject("array"));
+	EXPECT_EQ(map->getCount(), 5);
+
+	// lookup with different instances of equal values
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeObject(1))), "int");
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeObject(1.0f))), "float");
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeObject("1"))), "string");
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeObject(true))), "bool");
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeArray(1, 2))), "array");
+	EXPECT_THROW(map->get(Util::makeObject(2)), std::out_of_range);
+	EXPECT_FALSE(map->find(Util::makeArray(2, 1)));
+
+	// keys are copied
+	auto key = Util::makeArray(3);
+	map->set(key, Util::makeObject(3));
+	key->add(Util::makeObject(4));
+	EXPECT_TRUE(map->has(Util::makeArray(3)));
+	EXPECT_FALSE(map->has(key));
+
+	// replace
+	map->set(Util::makeObject(1), Util::makeObject("replaced"));
+	EXPECT_EQ(map->getCount(), 6);
+	EXPECT_EQ(Util::getBareString(map->get(Util::makeObject(1))), "replaced");
+}
+
+TEST(TestSuite, GrowAndRemove)
+{
+	auto map = std::make_shared<MapObject>();
+	map->reserve(100);
+	const int capacity = map->getCapacity();
+	EXPECT_GE(capacity, 100);
+
+	for (int i = 0; i < 1000; ++i)
+		map->set(Util::makeObject(i * 1024), Util::makeObject(i));
+	EXPECT_EQ(map->getCount(), 1000);
+	EXPECT_GT(map->getCapacity(), capacity);
+
+	// remove every second key
+	for (int i = 0; i < 1000; i += 2)
+		EXPECT_TRUE(map->remove(Util::makeObject(i * 1024)));
+	EXPECT_FALSE(map->remove(Util::makeObject(0)));
+	EXPECT_EQ(map->getCount(), 500);
+	for (int i = 0; i < 1000; ++i)
+		EXPECT_EQ(map->has(Util::makeObject(i * 1024)), i % 2 == 1);
+
+	map->rehash(0);
+	EXPECT_EQ(map->getCount(), 500);
+	EXPECT_GE(float(map->getCapacity()) * map->getMaxLoadFactor(), 500.0f);
+	EXPECT_EQ(Util::fromObject<int>(map->get(Util::makeObject(999 * 1024))), 999);
+}
+
+TEST(TestSuite, UtilityConversion)
+{
+	std::unordered_map<std::string, int> values = { {"a", 1}, {"b", 2} };
+	auto map = Util::makeObject(values);
+	EXPECT_EQ(map->getCount(), 2);
+	EXPECT_EQ(Util::fromObject<int>(map->get(Util::makeObject("b"))), 2);
+
+	auto back = Util::fromObject<std::unordered_map<std::string, int>>(map);
+	EXPECT_EQ(back, values);
+	EXPECT_THROW((Util::fromObject<std::unordered_map<int, int>>(map)), InvalidArgumentConversion);
+
+	auto clone = map->clone();
+	EXPECT_TRUE(clone->equals(map));
+	map->set(Util::makeObject("a"), Util::makeObject(3));
+	EXPECT_FALSE(clone->equals(map));
+}
+
+TEST(TestSuite, ScriptInterface)
+{
+	ScriptEngine engine;
+	engine.execute("m = Map()");
+	engine.execute("m.set(\"x\", 1).set([1, 2], \"pair\")");
+	EXPECT_EQ(engine.execute("m.getCount()")->toString(), "2");
+	EXPECT_EQ(engine.execute("m.get(\"x\")")->toString(), "1");
+	EXPECT_EQ(engine.execute("m.get(\"y\", 0)")->toString(), "0");
+	EXPECT_EQ(engine.execute("m.has([1, 2])")->toString(), "true");
+	EXPECT_EQ(engine.execute("m.remove(\"x\")")->toString(), "true");
+	EXPECT_EQ(engine.execute("m")->toString(), "{[1, 2]: \"pair\"}");
+	EXPECT_THROW(engine.execute("m.get(\"x\")"), std::runtime_error);
+}
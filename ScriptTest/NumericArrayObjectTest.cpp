@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "script/objects/IntArrayObject.h"
+#include "script/objects/FloatArrayObject.h"
+#include "script/NumericKernels.h"
+
+#define TestSuite NumericArrayObjectTest
+using namespace script;
+
+TEST(TestSuite, UtilityConversion)
+{
+	// std::vector<int> => IntArrayObject
+	auto obj = Util::makeObject(std::vector<int>{ 1, 2, 3 });
+	auto intArr = std::dynamic_pointer_cast<IntArrayObject>(obj);
+	ASSERT_TRUE(intArr);
+	EXPECT_EQ(intArr->getCount(), 3);
+	EXPECT_EQ(intArr->get(2), 3);
+
+	// IntArrayObject => std::vector<int>
+	auto vec = Util::fromObject<std::vector<int>>(obj);
+	EXPECT_EQ(vec, std::vector<int>({ 1, 2, 3 }));
+
+	// std::vector<float> => FloatArrayObject
+	obj = Util::makeObject(std::vector<float>{ 1.5f, 2.5f });
+	EXPECT_TRUE(std::dynamic_pointer_cast<FloatArrayObject>(obj));
+	EXPECT_EQ(Util::fromObject<std::vector<float>>(obj), std::vector<float>({ 1.5f, 2.5f }));
+}
+
+TEST(TestSuite, ArrayInterface)
+{
+	auto arr = std::make_shared<IntArrayObject>(std::vector<int>{ 3, 5, 7, 9 });
+	EXPECT_THROW(arr->get(-1), std::out_of_range);
+	EXPECT_THROW(arr->get(4), std::out_of_range);
+
+	arr->set(0, 1);
+	arr->add(11);
+	arr->remove(1);
+	EXPECT_EQ(arr->getValue(), std::vector<int>({ 1, 7, 9, 11 }));
+
+	auto slice = arr->slice(1, 2);
+	EXPECT_EQ(slice->getValue(), std::vector<int>({ 7, 9 }));
+	EXPECT_TRUE(std::dynamic_pointer_cast<IntArrayObject>(slice));
+	EXPECT_THROW(arr->slice(1, 5), std::out_of_range);
+
+	auto clone = arr->clone();
+	EXPECT_TRUE(clone->equals(arr));
+	arr->clear();
+	EXPECT_FALSE(clone->equals(arr));
+}
+
+TEST(TestSuite, WriteTo)
+{
+	IntArrayObject arr(std::vector<int>{ 1, 2, 3 });
+	StringSink sink(9);
+	arr.writeTo(sink);
+	EXPECT_EQ(sink.getString(), "[1, 2, 3]");
+	EXPECT_FALSE(sink.isTruncated());
+
+	// limit ends exactly after an element => the remaining elements are missing
+	StringSink exact(5);
+	arr.writeTo(exact);
+	EXPECT_EQ(exact.getString(), "[1, 2");
+	EXPECT_TRUE(exact.isTruncated());
+}
+
+TEST(TestSuite, ScriptInterface)
+{
+	ScriptEngine engine;
+	engine.execute("a = IntArray([1, 2, 3])");
+	engine.execute("a.add(4, 5)");
+	engine.execute("a.set(0, 10)");
+	EXPECT_EQ(engine.execute("a.getCount()")->toString(), "5");
+	EXPECT_EQ(engine.execute("a.get(0)")->toString(), "10");
+	EXPECT_EQ(engine.execute("a")->toString(), "[10, 2, 3, 4, 5]");
+	EXPECT_EQ(engine.execute("a.slice(3)")->toString(), "[4, 5]");
+
+	// no implicit conversion
+	EXPECT_THROW(engine.execute("a.add(1.0f)"), std::runtime_error);
+	EXPECT_THROW(engine.execute("FloatArray([1, 2])"), std::runtime_error);
+
+	engine.execute("f = FloatArray()");
+	engine.execute("f.addAll([1.0f, 2.0f])");
+	EXPECT_EQ(engine.execute("f.getCount()")->toString(), "2");
+	EXPECT_TRUE(engine.execute("f.toArray()")->equals(Util::makeArray(1.0f, 2.0f)));
+}
+
+TEST(TestSuite, ElementWiseKernels)
+{
+	const auto supported = kernels::getSupportedInstructionSet();
+	// 19 elements => vector loop + scalar remainder
+	std::vector<float> floats;
+	std::vector<int> ints;
+	for (int i = 0; i < 19; ++i)
+	{
+		floats.push_back(float(i) * 0.5f - 4.0f);
+		ints.push_back(i * 3 - 20);
+	}
+
+	for (auto set : { kernels::InstructionSet::Scalar, kernels::InstructionSet::SSE41, kernels::InstructionSet::AVX2 })
+	{
+		if (int(set) > int(supported)) break;
+		kernels::setInstructionSet(set);
+		EXPECT_EQ(kernels::getInstructionSet(), set);
+
+		FloatArrayObject f(floats);
+		FloatArrayObject other(floats);
+		f.multiplyEach(2.0f);
+		f.addEach(other);
+		f.subtractEach(1.0f);
+		f.divideEach(2.0f);
+		f.multiplyAddEach(2.0f, 0.5f);
+		for (size_t i = 0; i < floats.size(); ++i)
+			EXPECT_FLOAT_EQ(f.getValue()[i], (floats[i] * 3.0f - 1.0f) / 2.0f * 2.0f + 0.5f);
+
+		f.negateEach();
+		f.absEach();
+		f.clampEach(1.0f, 5.0f);
+		for (size_t i = 0; i < floats.size(); ++i)
+			EXPECT_FLOAT_EQ(f.getValue()[i], std::min(std::max(std::abs(floats[i] * 3.0f - 0.5f), 1.0f), 5.0f));
+
+		IntArrayObject a(ints);
+		IntArrayObject b(ints);
+		a.multiplyEach(b);
+		a.subtractEach(b);
+		a.addEach(7);
+		a.multiplyAddEach(b, b);
+		a.divideEach(3);
+		for (size_t i = 0; i < ints.size(); ++i)
+			EXPECT_EQ(a.getValue()[i], ((ints[i] * ints[i] - ints[i] + 7) * ints[i] + ints[i]) / 3);
+
+		a.negateEach();
+		a.absEach();
+		a.clampEach(10, 1000);
+		for (size_t i = 0; i < ints.size(); ++i)
+			EXPECT_EQ(a.getValue()[i], std::min(std::max(std::abs(((ints[i] * ints[i] - ints[i] + 7) * ints[i] + ints[i]) / 3), 10), 1000));
+
+		// integer overflow wraps in the vector loop and in the scalar remainder
+		const int intMax = std::numeric_limits<int>::max();
+		const int intMin = std::numeric_limits<int>::min();
+		IntArrayObject overflow(std::vector<int>(ints.size(), intMax));
+		overflow.addEach(1);
+		EXPECT_EQ(overflow.getValue(), std::vector<int>(ints.size(), intMin));
+		overflow.subtractEach(1);
+		EXPECT_EQ(overflow.getValue(), std::vector<int>(ints.size(), intMax));
+		overflow.multiplyAddEach(2, 2);
+		EXPECT_EQ(overflow.getValue(), std::vector<int>(ints.size(), 0));
+
+		// v * mul rounds before the addition in every path (a fused multiply-add would return 2^-24)
+		const float v = 1.0f + std::ldexp(1.0f, -12);
+		FloatArrayObject rounding(std::vector<float>(floats.size(), v));
+		rounding.multiplyAddEach(v, -(1.0f + std::ldexp(1.0f, -11)));
+		EXPECT_EQ(rounding.getValue(), std::vector<float>(floats.size(), 0.0f));
+	}
+
+	kernels::setInstructionSet(supported);
+}
+
+TEST(TestSuite, ElementWiseScript)
+{
+	ScriptEngine engine;
+	engine.execute("a = IntArray([1, 2, 3])");
+	engine.execute("a.multiplyEach(2).addEach(IntArray([1, 1, 1]))");
+	EXPECT_EQ(engine.execute("a")->toString(), "[3, 5, 7]");
+	engine.execute("a.multiplyAddEach(IntArray([1, 2, 3]), IntArray([0, 0, 1]))");
+	EXPECT_EQ(engine.execute("a")->toString(), "[3, 10, 22]");
+	engine.execute("a.negateEach().clampEach(-15, 0)");
+	EXPECT_EQ(engine.execute("a")->toString(), "[-3, -10, -15]");
+
+	// size mismatch, division by zero
+	EXPECT_THROW(engine.execute("a.addEach(IntArray([1, 2]))"), std::runtime_error);
+	EXPECT_THROW(engine.execute("a.divideEach(0)"), std::runtime_error);
+	EXPECT_THROW(engine.execute("a.divideEach(IntArray([1, 0, 1]))"), std::runtime_error);
+	EXPECT_THROW(engine.execute("a.clampEach(1, 0)"), std::runtime_error);
+
+	// INT_MIN / -1 overflows, negate and abs wrap
+	engine.setObject("m", Util::makeObject(std::vector<int>{ std::numeric_limits<int>::min(), 4 }));
+	EXPECT_THROW(engine.execute("m.divideEach(-1)"), std::runtime_error);
+	EXPECT_THROW(engine.execute("m.divideEach(IntArray([-1, 1]))"), std::runtime_error);
+	engine.execute("m.divideEach(IntArray([1, -1]))");
+	EXPECT_EQ(engine.execute("m")->toString(), "[-2147483648, -4]");
+	engine.execute("m.negateEach()");
+	EXPECT_EQ(engine.execute("m")->toString(), "[-2147483648, 4]");
+	engine.execute("m.negateEach().absEach()");
+	EXPECT_EQ(engine.execute("m")->toString(), "[-2147483648, 4]");
+
+	engine.execute("f = FloatArray([1.0f, -2.0f])");
+	engine.execute("f.absEach().divideEach(FloatArray([2.0f, 4.0f]))");
+	EXPECT_TRUE(engine.execute("f")->equals(Util::makeObject(std::vector<float>{ 0.5f, 0.5f })));
+}
+
+TEST(TestSuite, Reductions)
+{
+	const auto supported = kernels::getSupportedInstructionSet();
+	// enough elements for multiple pairwise blocks
+	std::vector<float> floats;
+	std::vector<int> ints;
+	double floatSum = 0.0;
+	long long intSum = 0;
+	for (int i = 0; i < 1003; ++i)
+	{
+		floats.push_back(float((i * 37) % 101) * 0.25f - 3.0f);
+		ints.push_back((i * 7919) % 2003 - 1000);
+		floatSum += floats.back();
+		intSum += ints.back();
+	}
+	const double floatMean = floatSum / double(floats.size());
+	double floatDeviation = 0.0;
+	for (auto f : floats)
+		floatDeviation += (f - floatMean) * (f - floatMean);
+
+	for (auto set : { kernels::InstructionSet::Scalar, kernels::InstructionSet::SSE41, kernels::InstructionSet::AVX2 })
+	{
+		if (int(set) > int(supported)) break;
+		kernels::setInstructionSet(set);
+
+		FloatArrayObject f(floats);
+		EXPECT_NEAR(f.getSum(), floatSum, 1e-3);
+		EXPECT_FLOAT_EQ(f.getMin(), *std::min_element(floats.begin(), floats.end()));
+		EXPECT_FLOAT_EQ(f.getMax(), *std::max_element(floats.begin(), floats.end()));
+		EXPECT_NEAR(f.getMean(), floatMean, 1e-5);
+		EXPECT_NEAR(f.getVariance(), floatDeviation / double(floats.size()), 1e-3);
+
+		IntArrayObject a(ints);
+		EXPECT_EQ(a.getSum(), int(intSum));
+		EXPECT_EQ(a.getMin(), *std::min_element(ints.begin(), ints.end()));
+		EXPECT_EQ(a.getMax(), *std::max_element(ints.begin(), ints.end()));
+		EXPECT_NEAR(a.getMean(), double(intSum) / double(ints.size()), 1e-4);
+	}
+	kernels::setInstructionSet(supported);
+
+	// NaN values are ignored by min and max
+	FloatArrayObject nan(std::vector<float>{ 2.0f, std::numeric_limits<float>::quiet_NaN(), -1.0f });
+	EXPECT_FLOAT_EQ(nan.getMin(), -1.0f);
+	EXPECT_FLOAT_EQ(nan.getMax(), 2.0f);
+
+	IntArrayObject empty;
+	EXPECT_EQ(empty.getSum(), 0);
+	EXPECT_THROW(empty.getMin(), std::runtime_error);
+	EXPECT_THROW(empty.getMean(), std::runtime_error);
+}
+
+TEST(TestSuite, Percentile)
+{
+	auto arr = std::make_shared<IntArrayObject>(std::vector<int>{ 7, 1, 5, 3, 9 });
+	EXPECT_FLOAT_EQ(arr->getPercentile(0.0f), 1.0f);
+	EXPECT_FLOAT_EQ(arr->getPercentile(50.0f), 5.0f);
+	EXPECT_FLOAT_EQ(arr->getPercentile(100.0f), 9.0f);
+	EXPECT_FLOAT_EQ(arr->getPercentile(12.5f), 2.0f);
+	EXPECT_THROW(arr->getPercentile(101.0f), std::out_of_range);
+	// the array itself is not reordered
+	EXPECT_EQ(arr->getValue(), std::vector<int>({ 7, 1, 5, 3, 9 }));
+
+	// NaN is greater than all numbers
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	FloatArrayObject withNan(std::vector<float>{ nan, 4.0f, nan, 1.0f, 3.0f, 2.0f });
+	EXPECT_FLOAT_EQ(withNan.getPercentile(0.0f), 1.0f);
+	EXPECT_FLOAT_EQ(withNan.getPercentile(40.0f), 3.0f);
+	EXPECT_FLOAT_EQ(withNan.getPercentile(50.0f), 3.5f);
+	EXPECT_TRUE(std::isnan(withNan.getPercentile(100.0f)));
+
+	// min and max of only NaN values => NaN. Infinity is an element
+	const float inf = std::numeric_limits<float>::infinity();
+	for (size_t count : { size_t(1), size_t(19) })
+	{
+		FloatArrayObject allNan(std::vector<float>(count, nan));
+		EXPECT_TRUE(std::isnan(allNan.getMin()));
+		EXPECT_TRUE(std::isnan(allNan.getMax()));
+	}
+	FloatArrayObject infinite(std::vector<float>{ nan, inf });
+	EXPECT_EQ(infinite.getMin(), inf);
+	EXPECT_EQ(infinite.getMax(), inf);
+
+	ScriptEngine engine;
+	engine.execute("f = FloatArray([1.0f, 2.0f, 3.0f, 4.0f])");
+	EXPECT_TRUE(engine.execute("f.getSum()")->equals(Util::makeObject(10.0f)));
+	EXPECT_TRUE(engine.execute("f.getMean()")->equals(Util::makeObject(2.5f)));
+	EXPECT_TRUE(engine.execute("f.getVariance()")->equals(Util::makeObject(1.25f)));
+	EXPECT_TRUE(engine.execute("f.getPercentile(50.0f)")->equals(Util::makeObject(2.5f)));
+	EXPECT_EQ(engine.execute("IntArray([4, -2]).getMin()")->toString(), "-2");
+}
@@ -0,0 +1,48 @@
+#include "pch.h"
+#include "script/objects/RangeObject.h"
+
+#define TestSuite RangeObjectTest
+using namespace script;
+
+TEST(TestSuite, Values)
+{
+	EXPECT_EQ(RangeObject(0, 5).toArray()->toString(), "[0, 1, 2, 3, 4]");
+	EXPECT_EQ(RangeObject(5, 0, -2).toArray()->toString(), "[5, 3, 1]");
+	EXPECT_EQ(RangeObject(0, 10, 3).getCount(), 4);
+	EXPECT_EQ(RangeObject(3, 3).getCount(), 0);
+	EXPECT_EQ(RangeObject(3, 0).getCount(), 0);
+	EXPECT_THROW(RangeObject(0, 1, 0), std::runtime_error);
+}
+
+TEST(TestSuite, Pipeline)
+{
+	const RangeObject range(0, 10);
+	EXPECT_EQ(range.skip(2)->take(3)->toArray()->toString(), "[2, 3, 4]");
+	EXPECT_EQ(range.map("multiply", Util::makeArray(2))->take(3)->toArray()->toString(), "[0, 2, 4]");
+	EXPECT_EQ(range.filter("equals", Util::makeArray(7))->toArray()->toString(), "[7]");
+	EXPECT_EQ(range.take(0)->getCount(), 0);
+
+	// the range is not modified by the pipeline
+	EXPECT_EQ(range.getCount(), 10);
+
+	EXPECT_EQ(range.sum()->toString(), "45");
+	EXPECT_EQ(range.map("multiply", Util::makeArray(2))->sum()->toString(), "90");
+	EXPECT_EQ(range.take(0)->sum()->toString(), "0");
+}
+
+TEST(TestSuite, TakeStopsEarly)
+{
+	// the iteration stops as soon as take is satisfied (the range would take minutes otherwise)
+	auto first = RangeObject(0, std::numeric_limits<int>::max()).map("toString", Util::makeArray())->filter("equals", Util::makeArray("3"))->take(1);
+	EXPECT_EQ(first->toArray()->toString(), "[\"3\"]");
+}
+
+TEST(TestSuite, ScriptInterface)
+{
+	ScriptEngine engine;
+	EXPECT_EQ(engine.execute("Range(4).toArray()")->toString(), "[0, 1, 2, 3]");
+	EXPECT_EQ(engine.execute("Range(1, 4).map(\"multiply\", 3).toArray()")->toString(), "[3, 6, 9]");
+	EXPECT_EQ(engine.execute("Range(0, 100, 10).skip(1).take(2).toArray()")->toString(), "[10, 20]");
+	EXPECT_EQ(engine.execute("Range(0, 1000).sum()")->toString(), "499500");
+	EXPECT_EQ(engine.execute("Range(0, 10).map(\"toString\").filter(\"equals\", \"5\").getCount()")->toString(), "1");
+}
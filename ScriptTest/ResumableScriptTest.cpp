@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "script/ResumableScript.h"
+
+#define TestSuite ResumableScriptTest
+using namespace script;
+
+TEST(TestSuite, Yield)
+{
+	ScriptEngine engine;
+	// no script is resumed
+	EXPECT_EQ(engine.execute("System.yield()")->toString(), "false");
+
+	auto script = engine.executeResumable("a = 1;\nSystem.yield();\nb = 2; // comment\nSystem.yield();");
+	EXPECT_EQ(script->getState(), ResumableScript::State::Suspended);
+	EXPECT_EQ(script->getExecutedCount(), 2);
+	EXPECT_EQ(script->getResult()->toString(), "true");
+	EXPECT_EQ(engine.execute("a")->toString(), "1");
+	EXPECT_EQ(engine.getObject("b"), nullptr);
+
+	// a yield in the last statement finishes the script
+	EXPECT_EQ(script->resume(), ResumableScript::State::Finished);
+	EXPECT_EQ(engine.execute("b")->toString(), "2");
+	EXPECT_THROW(script->resume(), std::runtime_error);
+}
+
+TEST(TestSuite, NestedExecution)
+{
+	ScriptEngine engine;
+	engine.execute("log = []");
+
+	// the budget counts steps
+	auto script = engine.executeResumable("log.add(1);\nlog.add(2);\nlog.add(3);", 2);
+	EXPECT_EQ(script->getExecutedCount(), 2);
+	EXPECT_EQ(script->resume(), ResumableScript::State::Finished);
+
+	// the steps of a nested execution are counted. The script is suspended after the statement
+	script = engine.executeResumable("Engine.execute(\"log.add(4).add(5).add(6)\");\nlog.add(7);", 2);
+	EXPECT_EQ(script->getExecutedCount(), 1);
+	EXPECT_EQ(engine.execute("log")->toString(), "[1, 2, 3, 4, 5, 6]");
+
+	// a yield inside a nested execution suspends after the statement
+	script = engine.executeResumable("a = Engine.execute(\"System.yield()\");\nb = 2;");
+	EXPECT_EQ(script->getState(), ResumableScript::State::Suspended);
+	EXPECT_EQ(script->getExecutedCount(), 1);
+	EXPECT_EQ(engine.execute("a")->toString(), "true");
+	EXPECT_EQ(engine.getObject("b"), nullptr);
+	EXPECT_EQ(script->resume(), ResumableScript::State::Finished);
+	EXPECT_EQ(engine.execute("b")->toString(), "2");
+}
+
+TEST(TestSuite, Multiplex)
+{
+	ScriptEngine engine;
+	engine.execute("log = []");
+
+	// the sessions are resumed round robin with one statement each
+	std::vector<std::unique_ptr<ResumableScript>> sessions;
+	for (int i = 0; i < 3; ++i)
+	{
+		std::string script;
+		for (int j = 0; j < 4; ++j)
+			script += "log.add(" + std::to_string(i) + ");";
+		sessions.push_back(engine.executeResumable(script, 0));
+	}
+
+	size_t finished = 0;
+	while (finished != sessions.size())
+	{
+		finished = 0;
+		for (auto& s : sessions)
+		{
+			if (s->isFinished() || s->resume(1) == ResumableScript::State::Finished)
+				++finished;
+		}
+	}
+	EXPECT_EQ(engine.execute("log")->toString(), "[0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2]");
+}
+
+TEST(TestSuite, Errors)
+{
+	ScriptEngine engine;
+	auto script = engine.executeResumable("a = 1;\nb = a.missing();\nc = 3;", 0);
+	try
+	{
+		script->resume();
+		FAIL();
+	}
+	catch (const std::exception& e)
+	{
+		EXPECT_NE(std::string(e.what()).find("line 2:"), std::string::npos);
+	}
+	EXPECT_TRUE(script->isFinished());
+	EXPECT_EQ(engine.getObject("c"), nullptr);
+
+	script = engine.executeResumable("a = 1;\nb = 2", 0);
+	EXPECT_THROW(script->resume(), std::runtime_error);
+	EXPECT_TRUE(script->isFinished());
+}
@@ -2,6 +2,10 @@
 
 #include "script/objects/FloatObject.h"
 #include "script/Tokenizer.h"
+#include "script/ScriptImage.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
 
 #define TestSuite ScriptEngineTest
 using namespace script;
@@ -220,4 +224,311 @@ TEST(TestSuite, GetObjectsTest)
 	// null object
 	engine.setObject("obj1", script::NullObject::get());
 	EXPECT_EQ(engine.getObject<FloatObject>("obj1"), nullptr);
-}
\ No newline at end of file
+}
+
+TEST(TestSuite, ForkTest)
+{
+	ScriptEngine prototype;
+	prototype.execute("config = [1, 2]");
+	prototype.execute("name = \"proto\"");
+	prototype.execute("alias = config");
+	EXPECT_THROW(prototype.fork(), std::runtime_error);
+
+	prototype.freeze();
+	EXPECT_TRUE(prototype.isFrozen());
+	EXPECT_THROW(prototype.execute("a = 1"), std::runtime_error);
+	// the frozen engine is reported before the syntax error
+	try
+	{
+		prototype.execute("a = (");
+		FAIL();
+	}
+	catch (const std::runtime_error& e)
+	{
+		EXPECT_NE(std::string(e.what()).find("frozen"), std::string::npos);
+	}
+	EXPECT_THROW(prototype.setObject("a", Util::makeObject(1)), std::runtime_error);
+
+	auto fork1 = prototype.fork();
+	auto fork2 = prototype.fork();
+
+	// statics are shared, IO and Engine are bound to the fork
+	EXPECT_EQ(fork1->getStaticObject("System"), prototype.getStaticObject("System"));
+	EXPECT_EQ(fork1->getStaticFunctions(), prototype.getStaticFunctions());
+	EXPECT_NE(fork1->getStaticObject("Engine"), prototype.getStaticObject("Engine"));
+	EXPECT_EQ(fork1->execute("Int(3)")->toString(), "3");
+
+	// variables are copied on access
+	fork1->execute("config.add(3)");
+	EXPECT_EQ(fork1->execute("config")->toString(), "[1, 2, 3]");
+	EXPECT_EQ(fork2->execute("config")->toString(), "[1, 2]");
+	EXPECT_EQ(prototype.getObject("config")->toString(), "[1, 2]");
+
+	// variables that alias one object in the prototype alias its copy in the fork
+	EXPECT_EQ(fork1->getObject("alias"), fork1->getObject("config"));
+	EXPECT_EQ(fork1->execute("alias")->toString(), "[1, 2, 3]");
+	fork2->execute("alias.add(4)");
+	EXPECT_EQ(fork2->execute("config")->toString(), "[1, 2, 4]");
+	EXPECT_EQ(prototype.getObject("config")->toString(), "[1, 2]");
+
+	// variables of the fork are private
+	fork1->execute("x = 5");
+	EXPECT_EQ(fork2->getObject("x"), nullptr);
+	EXPECT_EQ(fork1->getObjects().size(), size_t(4));
+
+	// removed prototype variables stay removed
+	fork2->setObject("name", nullptr);
+	EXPECT_EQ(fork2->getObject("name"), nullptr);
+	EXPECT_EQ(fork2->getObjects().size(), size_t(2));
+	fork1->clearObjects();
+	EXPECT_EQ(fork1->getObject("config"), nullptr);
+	EXPECT_EQ(fork1->getObjects().size(), size_t(0));
+
+	// Engine.clearObjects() acts on the fork
+	fork2->execute("Engine.clearObjects()");
+	EXPECT_EQ(fork2->getObjects().size(), size_t(0));
+	EXPECT_EQ(prototype.getObjects().size(), size_t(3));
+}
+
+TEST(TestSuite, BatchTest)
+{
+	ScriptEngine engine;
+	const std::vector<std::string> commands = { "a = 1", "a = a + Int(2)", "", "b = (", "a = a + Int(1)", "a" };
+
+	// execution order and syntax error
+	auto res = engine.executeBatch(commands, ScriptEngine::BatchPolicy::ContinueOnError);
+	ASSERT_EQ(res.size(), commands.size());
+	EXPECT_EQ(res[1].value->toString(), "3");
+	EXPECT_EQ(res[2].value, NullObject::get());
+	EXPECT_EQ(res[3].value, nullptr);
+	EXPECT_THROW(std::rethrow_exception(res[3].error), std::runtime_error);
+	EXPECT_EQ(res[5].value->toString(), "4");
+	EXPECT_EQ(engine.getObject("b"), nullptr);
+
+	// stop at the first error
+	res = engine.executeBatch(std::vector<std::string>{ "a = 1", "a.unknown()", "a = 5" });
+	EXPECT_EQ(res[0].value->toString(), "1");
+	EXPECT_NE(res[1].error, nullptr);
+	EXPECT_EQ(res[2].value, nullptr);
+	EXPECT_EQ(res[2].error, nullptr);
+	EXPECT_EQ(engine.execute("a")->toString(), "1");
+
+	// parallel compilation gives the same results
+	std::vector<std::string> many = { "s = 0" };
+	for (int i = 0; i < 500; ++i)
+		many.push_back("s = s + Int(" + std::to_string(i) + ")");
+	res = engine.executeBatch(many, ScriptEngine::BatchPolicy::StopOnError, true);
+	EXPECT_EQ(res.back().value->toString(), std::to_string(499 * 500 / 2));
+
+	// compiled commands can be executed several times
+	const auto compiled = engine.compile("s = s + Int(1)");
+	engine.execute(compiled);
+	EXPECT_EQ(engine.execute(compiled)->toString(), std::to_string(499 * 500 / 2 + 2));
+	EXPECT_THROW(engine.compile("s = ("), std::runtime_error);
+
+	// the text is copied unless the caller keeps the source alive
+	const std::string source = "s = s + Int(2)";
+	EXPECT_NE(engine.compile(source).text.data(), source.data());
+	const auto view = engine.compile(source, false);
+	EXPECT_EQ(view.text.data(), source.data());
+	EXPECT_EQ(view.storage, nullptr);
+	EXPECT_EQ(engine.execute(view)->toString(), std::to_string(499 * 500 / 2 + 4));
+}
+
+TEST(TestSuite, ExecuteFileTest)
+{
+	ScriptEngine engine;
+	const std::string filename = "executeFileTest.txt";
+	{
+		std::ofstream file(filename);
+		file << "// comment;\n";
+		for (int i = 0; i < 300; ++i)
+			file << "a" << i << " = Int(" << i << ");\n";
+		file << "b = Int(7);\n";
+	}
+	EXPECT_EQ(engine.execute("IO.executeFile(\"" + filename + "\")")->toString(), "7");
+	EXPECT_EQ(engine.execute("a299")->toString(), "299");
+
+	// syntax error in line 4 (after an empty line) once line 2 was executed
+	{
+		std::ofstream file(filename);
+		file << "c = 1;\nd = 2;\n\ne = (;\nf = 4;";
+	}
+	try
+	{
+		engine.execute("IO.executeFile(\"" + filename + "\")");
+		FAIL();
+	}
+	catch (const std::exception& e)
+	{
+		EXPECT_NE(std::string(e.what()).find(filename + " line 4:"), std::string::npos);
+	}
+	EXPECT_EQ(engine.execute("d")->toString(), "2");
+	EXPECT_EQ(engine.getObject("f"), nullptr);
+	std::remove(filename.c_str());
+}
+
+TEST(TestSuite, ExecuteFileCommentsTest)
+{
+	ScriptEngine engine;
+	const std::string filename = "executeFileCommentsTest.txt";
+	{
+		std::ofstream file(filename);
+		file << "a = [1, // first; element\n   2]; // second\n// only a comment;\nb = Int(3) // trailing\n;\n;c = 4;";
+	}
+	EXPECT_EQ(engine.execute("IO.executeFile(\"" + filename + "\")")->toString(), "4");
+	EXPECT_EQ(engine.execute("a")->toString(), "[1, 2]");
+	EXPECT_EQ(engine.execute("b")->toString(), "3");
+
+	// the last statement has no semicolon
+	{
+		std::ofstream file(filename, std::ios::trunc);
+		file << "x = 1;\ny = 2";
+	}
+	EXPECT_THROW(engine.execute("IO.executeFile(\"" + filename + "\")"), std::runtime_error);
+	EXPECT_EQ(engine.execute("x")->toString(), "1");
+
+	// the file is mapped, empty files can be read as well
+	{
+		std::ofstream file(filename, std::ios::trunc);
+	}
+	EXPECT_EQ(engine.execute("IO.readFile(\"" + filename + "\")")->toString(), "\"\"");
+	EXPECT_EQ(engine.execute("IO.executeFile(\"" + filename + "\")"), NullObject::get());
+	std::remove(filename.c_str());
+	EXPECT_THROW(engine.execute("IO.readFile(\"" + filename + "\")"), std::runtime_error);
+}
+
+TEST(TestSuite, ScriptImageTest)
+{
+	const std::string scriptFile = "scriptImageTest.txt";
+	const std::string imageFile = "scriptImageTest.img";
+	{
+		std::ofstream file(scriptFile);
+		file << "a = [1, 2.5, true, null, \"str\"]; // comment\n";
+		file << "b = Int(3);\nb += 4;\nc = -b * 2;\n";
+		file << "d = a.get(4).getLength() + a.Count;\ne = String(\"x\").add(Int(1).toString());\n";
+		file << "f = Clock.getDate().getYear();\ng = b.equals(7);";
+	}
+
+	// the image produces the same results as the script
+	ScriptEngine reference;
+	reference.execute("IO.executeFile(\"" + scriptFile + "\")");
+	ScriptEngine engine;
+	engine.execute("IO.compileFile(\"" + scriptFile + "\", \"" + imageFile + "\")");
+	EXPECT_EQ(engine.execute("IO.executeImage(\"" + imageFile + "\")")->toString(), "true");
+	for (const auto& name : { "a", "b", "c", "d", "e", "f", "g" })
+		EXPECT_EQ(engine.getObject(name)->toString(), reference.getObject(name)->toString());
+
+	// the image must be executed with the same statics
+	ScriptEngine other;
+	other.setStaticFunction("Extra", Util::fromLambda([]() { return true; }, "Extra()"));
+	EXPECT_THROW(other.execute("IO.executeImage(\"" + imageFile + "\")"), std::runtime_error);
+	EXPECT_EQ(other.getObject("a"), nullptr);
+
+	// runtime errors report the line of the script
+	{
+		std::ofstream file(scriptFile);
+		file << "x = 1;\n\ny = x.missing();";
+	}
+	engine.execute("IO.compileFile(\"" + scriptFile + "\", \"" + imageFile + "\")");
+	try
+	{
+		engine.execute("IO.executeImage(\"" + imageFile + "\")");
+		FAIL();
+	}
+	catch (const std::exception& e)
+	{
+		EXPECT_NE(std::string(e.what()).find(imageFile + " line 3:"), std::string::npos);
+	}
+
+	const auto readImage = [&imageFile]()
+	{
+		std::ifstream in(imageFile, std::ios::binary);
+		return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	};
+	const auto writeImage = [&imageFile](const std::string& data)
+	{
+		std::ofstream out(imageFile, std::ios::binary | std::ios::trunc);
+		out.write(data.data(), data.size());
+	};
+
+	// nodes with several parents are rejected (the token tree could grow exponentially)
+	{
+		auto data = readImage();
+		image::Header header;
+		std::memcpy(&header, data.data(), sizeof(header));
+		ASSERT_EQ(header.statementCount, 2u);
+		// the second statement uses the root node of the first statement
+		std::memcpy(&data[header.statementOffset + 3 * sizeof(uint32_t)], &data[header.statementOffset], sizeof(uint32_t));
+		writeImage(data);
+	}
+	EXPECT_THROW(engine.execute("IO.executeImage(\"" + imageFile + "\")"), std::runtime_error);
+
+	// scripts and truncated images are rejected
+	EXPECT_THROW(engine.execute("IO.executeImage(\"" + scriptFile + "\")"), std::runtime_error);
+	engine.execute("IO.compileFile(\"" + scriptFile + "\", \"" + imageFile + "\")");
+	{
+		const auto data = readImage();
+		writeImage(data.substr(0, data.size() - 8));
+	}
+	EXPECT_THROW(engine.execute("IO.executeImage(\"" + imageFile + "\")"), std::runtime_error);
+
+	std::remove(scriptFile.c_str());
+	std::remove(imageFile.c_str());
+}
+
+TEST(TestSuite, LimitsTest)
+{
+	ScriptEngine engine;
+	using Reason = ExecutionAbortedException::Reason;
+	const auto getReason = [&engine](const std::string& command)
+	{
+		try
+		{
+			engine.execute(command);
+		}
+		catch (const ExecutionAbortedException& e)
+		{
+			return int(e.reason);
+		}
+		return -1;
+	};
+	// 1999 operators (more than one check interval)
+	std::string longCommand = "x = 1";
+	for (int i = 0; i < 1999; ++i)
+		longCommand += " + 1";
+
+	// function calls and operators are steps
+	const auto start = engine.getStepCount();
+	engine.setStepLimit(3);
+	EXPECT_EQ(engine.execute("Int(1) + Int(2)")->toString(), "3");
+	EXPECT_EQ(engine.getStepCount(), start + 3);
+	EXPECT_EQ(getReason("Int(1)"), int(Reason::StepLimit));
+	EXPECT_EQ(getReason("a = 1"), -1);
+
+	// nested executions share the limit
+	engine.resetLimits();
+	engine.execute("f = \"Engine.execute(f)\"");
+	engine.setStepLimit(100);
+	EXPECT_EQ(getReason("Engine.execute(f)"), int(Reason::StepLimit));
+
+	engine.resetLimits();
+	engine.setDeadline(std::chrono::steady_clock::now() - std::chrono::seconds(1));
+	EXPECT_EQ(getReason(longCommand), int(Reason::Deadline));
+	engine.resetLimits();
+	engine.cancel();
+	// the next step fails
+	EXPECT_EQ(getReason("Int(1)"), int(Reason::Cancelled));
+	EXPECT_EQ(getReason("Int(1)"), int(Reason::Cancelled));
+	EXPECT_EQ(getReason(longCommand), int(Reason::Cancelled));
+	EXPECT_EQ(engine.getObject("x"), nullptr);
+
+	// the batch stops regardless of the policy
+	auto res = engine.executeBatch(std::vector<std::string>{ longCommand, "y = 1" }, ScriptEngine::BatchPolicy::ContinueOnError);
+	EXPECT_NE(res[0].error, nullptr);
+	EXPECT_EQ(res[1].error, nullptr);
+	EXPECT_EQ(engine.getObject("y"), nullptr);
+
+	engine.resetLimits();
+	EXPECT_EQ(engine.execute(longCommand)->toString(), "2000");
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include <thread>
+#include <atomic>
+#include "script/ScriptExecutor.h"
+
+#define TestSuite ScriptExecutorTest
+using namespace script;
+
+TEST(TestSuite, ExecuteAsync)
+{
+	ScriptEngine engine;
+	std::atomic<bool> inline_ = false;
+	const auto host = std::this_thread::get_id();
+	engine.setStaticFunction("Check", Util::fromLambda([&]()
+	{
+		if (std::this_thread::get_id() == host)
+			inline_ = true;
+		return true;
+	}, "Check()"));
+
+	auto first = engine.executeAsync("a = 0");
+	std::vector<std::future<ScriptObjectPtr>> results;
+	for (int i = 0; i < 100; ++i)
+		results.push_back(engine.executeAsync("a = a + Int(1)"));
+	engine.executeAsync("Check()").get();
+
+	EXPECT_EQ(first.get()->toString(), "0");
+	// commands of one engine are executed in order
+	for (int i = 0; i < 100; ++i)
+		EXPECT_EQ(results[i].get()->toString(), std::to_string(i + 1));
+	EXPECT_FALSE(inline_);
+}
+
+TEST(TestSuite, Exception)
+{
+	ScriptEngine engine;
+	auto res = engine.executeAsync("a = ");
+	EXPECT_THROW(res.get(), std::runtime_error);
+	EXPECT_EQ(engine.executeAsync("Int(2)").get()->toString(), "2");
+}
+
+TEST(TestSuite, ManyEngines)
+{
+	ScriptExecutor executor(2);
+	EXPECT_EQ(executor.getThreadCount(), size_t(2));
+	constexpr int EngineCount = 6;
+	constexpr int Commands = 300;
+
+	std::vector<std::unique_ptr<ScriptEngine>> engines;
+	for (int i = 0; i < EngineCount; ++i)
+	{
+		engines.push_back(std::make_unique<ScriptEngine>());
+		engines.back()->setObject("log", std::make_shared<ArrayObject>());
+	}
+
+	// one producer per engine
+	std::vector<std::thread> producers;
+	for (int e = 0; e < EngineCount; ++e)
+		producers.emplace_back([&, e]()
+		{
+			for (int i = 0; i < Commands; ++i)
+				executor.submit(*engines[e], "log.add(Int(" + std::to_string(i) + "))");
+		});
+	for (auto& p : producers)
+		p.join();
+
+	// the destructor waits for the pending commands
+	engines.back().reset();
+
+	for (int e = 0; e + 1 < EngineCount; ++e)
+	{
+		executor.submit(*engines[e], "0").get();
+		const auto log = engines[e]->getObject<ArrayObject>("log");
+		ASSERT_EQ(log->getCount(), Commands);
+		for (int i = 0; i < Commands; ++i)
+			ASSERT_EQ(log->get(i)->toString(), std::to_string(i));
+	}
+}
@@ -1,4 +1,7 @@
 #include "pch.h"
+#include "script/objects/FloatObject.h"
+#include "script/objects/IntArrayObject.h"
+#include "script/statics/TimestampObject.h"
 
 #define TestSuite ScriptObjectTest
 using namespace script;
@@ -29,6 +32,28 @@ TEST(TestSuite, Equals)
 	ASSERT_TRUE(b->equals(Util::makeObject(false)));
 }
 
+TEST(TestSuite, HashCode)
+{
+	// equal values => equal hashes
+	EXPECT_EQ(Util::makeObject(23)->hashCode(), Util::makeObject(23)->hashCode());
+	EXPECT_EQ(Util::makeObject(0.0f)->hashCode(), Util::makeObject(-0.0f)->hashCode());
+	EXPECT_EQ(Util::makeObject(true)->hashCode(), Util::makeObject(true)->hashCode());
+	EXPECT_EQ(Util::makeObject("text")->hashCode(), Util::makeObject(std::string("text"))->hashCode());
+	EXPECT_EQ(Util::makeObject(std::vector<int>{ 1, 2 })->hashCode(), std::make_shared<IntArrayObject>(std::vector<int>{ 1, 2 })->hashCode());
+
+	const auto now = std::chrono::high_resolution_clock::now();
+	EXPECT_EQ(std::make_shared<TimestampObject>(now)->hashCode(), std::make_shared<TimestampObject>(now)->hashCode());
+
+	// the hash follows the value
+	auto i = Util::makeObject(1);
+	const auto before = i->hashCode();
+	i->invoke("add", Util::makeArray(1));
+	EXPECT_EQ(i->hashCode(), Util::makeObject(2)->hashCode());
+	EXPECT_NE(i->hashCode(), before);
+
+	EXPECT_NE(Util::makeObject("a")->hashCode(), Util::makeObject("b")->hashCode());
+}
+
 TEST(TestSuite, AddFunction)
 {
 	class Dummy : public ScriptObject
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "script/objects/SetObject.h"
+#include "script/objects/IntArrayObject.h"
+
+#define TestSuite SetObjectTest
+using namespace script;
+
+TEST(TestSuite, IntegerMembers)
+{
+	SetObject set(*Util::makeArray(5, 1, 3, 1, 5));
+	EXPECT_TRUE(set.isFlat());
+	EXPECT_EQ(set.getCount(), 3);
+	EXPECT_EQ(set.toString(), "{1, 3, 5}");
+
+	EXPECT_TRUE(set.has(Util::makeObject(3)));
+	EXPECT_FALSE(set.has(Util::makeObject(2)));
+	EXPECT_FALSE(set.has(Util::makeObject(3.0f)));
+
+	EXPECT_TRUE(set.add(Util::makeObject(2)));
+	EXPECT_FALSE(set.add(Util::makeObject(2)));
+	EXPECT_TRUE(set.remove(Util::makeObject(1)));
+	EXPECT_FALSE(set.remove(Util::makeObject(1)));
+	EXPECT_EQ(set.toString(), "{2, 3, 5}");
+	EXPECT_TRUE(set.equals(std::make_shared<SetObject>(std::vector<int>{ 5, 3, 2 })));
+}
+
+TEST(TestSuite, ValueMembers)
+{
+	SetObject set(*Util::makeArray(1, "1", 1.0f, Util::makeArray(1, 2)));
+	EXPECT_FALSE(set.isFlat());
+	EXPECT_EQ(set.getCount(), 4);
+
+	// lookup with different instances of equal values
+	EXPECT_TRUE(set.has(Util::makeObject(1)));
+	EXPECT_TRUE(set.has(Util::makeObject("1")));
+	EXPECT_TRUE(set.has(Util::makeObject(1.0f)));
+	EXPECT_TRUE(set.has(Util::makeArray(1, 2)));
+	EXPECT_FALSE(set.has(Util::makeArray(2, 1)));
+
+	// members are copied
+	auto member = Util::makeArray(3);
+	set.add(member);
+	member->add(Util::makeObject(4));
+	EXPECT_TRUE(set.has(Util::makeArray(3)));
+	EXPECT_FALSE(set.has(member));
+
+	set.clear();
+	EXPECT_TRUE(set.isFlat());
+	EXPECT_EQ(set.getCount(), 0);
+}
+
+TEST(TestSuite, SetAlgebra)
+{
+	// flat and generic sets produce the same results
+	for (bool flat : { true, false })
+	{
+		auto a = std::make_shared<SetObject>(std::vector<int>{ 1, 2, 3, 4 });
+		auto b = std::make_shared<SetObject>(std::vector<int>{ 3, 4, 5 });
+		if (!flat)
+		{
+			a->add(Util::makeObject("x"));
+			a->remove(Util::makeObject("x"));
+		}
+		EXPECT_EQ(a->isFlat(), flat);
+
+		EXPECT_TRUE(a->getUnion(*b)->equals(std::make_shared<SetObject>(std::vector<int>{ 1, 2, 3, 4, 5 })));
+		EXPECT_TRUE(a->getIntersection(*b)->equals(std::make_shared<SetObject>(std::vector<int>{ 3, 4 })));
+		EXPECT_TRUE(b->getIntersection(*a)->equals(std::make_shared<SetObject>(std::vector<int>{ 3, 4 })));
+		EXPECT_TRUE(a->getDifference(*b)->equals(std::make_shared<SetObject>(std::vector<int>{ 1, 2 })));
+		EXPECT_TRUE(b->getDifference(*a)->equals(std::make_shared<SetObject>(std::vector<int>{ 5 })));
+		EXPECT_EQ(a->getUnion(*b)->hashCode(), std::make_shared<SetObject>(std::vector<int>{ 1, 2, 3, 4, 5 })->hashCode());
+	}
+}
+
+TEST(TestSuite, ScriptInterface)
+{
+	ScriptEngine engine;
+	engine.execute("a = Set([1, 2, 3])");
+	engine.execute("b = Set(IntArray([2, 3, 4]))");
+	EXPECT_EQ(engine.execute("a.has(2)")->toString(), "true");
+	EXPECT_EQ(engine.execute("a.add(2)")->toString(), "false");
+	EXPECT_EQ(engine.execute("a.getIntersection(b)")->toString(), "{2, 3}");
+	EXPECT_EQ(engine.execute("a.getUnion(b).getCount()")->toString(), "4");
+	EXPECT_EQ(engine.execute("a.getDifference(b).toArray()")->toString(), "[1]");
+	EXPECT_EQ(engine.execute("Set()")->toString(), "{}");
+}
@@ -0,0 +1,134 @@
+#include "pch.h"
+#include "script/objects/StringObject.h"
+
+#define TestSuite StringObjectTest
+using namespace script;
+
+TEST(TestSuite, SharedBuffer)
+{
+	const std::string longText(StringObject::ChunkSize, 'a');
+	auto str = std::make_shared<StringObject>(longText);
+	auto clone = std::dynamic_pointer_cast<StringObject>(str->clone());
+	ASSERT_TRUE(clone);
+	// long strings are stored in a shared chunk
+	EXPECT_EQ(clone->getView().data(), str->getView().data());
+
+	// the shared chunk is not modified: the original stays valid while the clone appends
+	const auto original = str->getView();
+	clone->append("b");
+	EXPECT_NE(clone->getView().data(), original.data());
+	EXPECT_EQ(original, longText);
+	str->append("c");
+	EXPECT_EQ(clone->getView(), longText + "b");
+	EXPECT_EQ(str->getView(), longText + "c");
+	EXPECT_FALSE(str->equals(clone));
+
+	// appending itself
+	auto shortStr = std::make_shared<StringObject>("ab");
+	shortStr->add(Util::makeArray(shortStr, 1));
+	EXPECT_EQ(shortStr->getValue(), "abab1");
+}
+
+TEST(TestSuite, ClonesShareChunks)
+{
+	// every clone keeps its value while the original appends into new chunks
+	auto str = std::make_shared<StringObject>("");
+	std::vector<std::shared_ptr<StringObject>> versions;
+	for (size_t i = 0; i < 3 * StringObject::ChunkSize; ++i)
+	{
+		versions.push_back(std::dynamic_pointer_cast<StringObject>(str->clone()));
+		str->append(std::to_string(i % 10));
+	}
+	for (size_t i = 0; i < versions.size(); ++i)
+	{
+		ASSERT_EQ(versions[i]->getLength(), int(i));
+		EXPECT_EQ(versions[i]->getView(), str->getView().substr(0, i));
+	}
+
+	// appending the flattened value to itself
+	auto copy = std::dynamic_pointer_cast<StringObject>(str->clone());
+	copy->add(Util::makeArray(copy));
+	EXPECT_EQ(copy->getView(), std::string(str->getView()) + std::string(str->getView()));
+}
+
+TEST(TestSuite, GetValueDetaches)
+{
+	auto str = std::make_shared<StringObject>(std::string(StringObject::ChunkSize, 'a'));
+	auto clone = std::dynamic_pointer_cast<StringObject>(str->clone());
+	std::string& value = clone->getValue();
+	value = "modified";
+	EXPECT_EQ(clone->getLength(), 8);
+	EXPECT_EQ(str->getLength(), int(StringObject::ChunkSize));
+
+	// the exposed string will be copied on clone
+	auto copy = clone->clone();
+	value += "!";
+	EXPECT_EQ(copy->toString(), "\"modified\"");
+	EXPECT_EQ(clone->toString(), "\"modified!\"");
+}
+
+TEST(TestSuite, ScriptAppend)
+{
+	ScriptEngine engine;
+	engine.execute("s = \"\"");
+	for (int i = 0; i < 100; ++i)
+		engine.execute("s = s + \"0123456789\"");
+	EXPECT_EQ(engine.execute("s.getLength()")->toString(), "1000");
+	EXPECT_EQ(Util::fromObject<std::string>(engine.getObject("s")), [] { std::string s; for (int i = 0; i < 100; ++i) s += "0123456789"; return s; }());
+}
+
+TEST(TestSuite, InternedLiterals)
+{
+	ScriptEngine engine;
+	auto a = std::dynamic_pointer_cast<StringObject>(engine.execute("\"interned\""));
+	auto b = std::dynamic_pointer_cast<StringObject>(engine.execute("x = \"interned\""));
+	ASSERT_TRUE(a);
+	ASSERT_TRUE(b);
+	// same payload without copying characters
+	EXPECT_EQ(a->getView().data(), b->getView().data());
+
+	// copy on write
+	engine.execute("x.add(\"!\")");
+	EXPECT_EQ(a->getView(), "interned");
+	EXPECT_EQ(b->getView(), "interned!");
+	auto c = std::dynamic_pointer_cast<StringObject>(engine.execute("\"interned\""));
+	EXPECT_EQ(c->getView().data(), a->getView().data());
+	a->getValue() += "?";
+	EXPECT_EQ(c->getView(), "interned");
+}
+
+TEST(TestSuite, StringTable)
+{
+	StringTable table;
+	auto a = table.intern("a");
+	EXPECT_EQ(table.intern("a"), a);
+	EXPECT_NE(table.intern("b"), a);
+	EXPECT_EQ(table.size(), size_t(2));
+
+	// "b" is not referenced anymore
+	table.collect();
+	EXPECT_EQ(table.size(), size_t(1));
+	EXPECT_EQ(*table.intern("a"), "a");
+}
+
+TEST(TestSuite, HashCode)
+{
+	auto str = std::make_shared<StringObject>("abc");
+	const auto hash = str->hashCode();
+	EXPECT_EQ(hash, Util::makeObject("abc")->hashCode());
+	EXPECT_EQ(hash, str->hashCode());
+
+	// append invalidates the cached hash
+	str->append("d");
+	EXPECT_EQ(str->hashCode(), Util::makeObject("abcd")->hashCode());
+
+	// modification through the exposed buffer
+	str->getValue() = "abc";
+	EXPECT_EQ(str->hashCode(), hash);
+	str->getValue() += "d";
+	EXPECT_EQ(str->hashCode(), Util::makeObject("abcd")->hashCode());
+
+	// interned payload
+	const auto payload = std::make_shared<const std::string>("abc");
+	EXPECT_EQ(std::make_shared<StringObject>(payload)->hashCode(), hash);
+}
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include <atomic>
+#include "script/ThreadPool.h"
+
+#define TestSuite ThreadPoolTest
+using namespace script;
+
+TEST(TestSuite, ParallelFor)
+{
+	ThreadPool pool(4);
+	EXPECT_EQ(pool.getThreadCount(), size_t(4));
+
+	std::vector<int> values(100000, 0);
+	std::atomic<int> chunks = 0;
+	pool.parallelFor(values.size(), 1000, [&](size_t begin, size_t end)
+	{
+		EXPECT_LE(end - begin, size_t(1000));
+		for (size_t i = begin; i < end; ++i)
+			values[i] += int(i);
+		++chunks;
+	});
+	EXPECT_EQ(chunks, 100);
+	for (size_t i = 0; i < values.size(); ++i)
+		ASSERT_EQ(values[i], int(i));
+}
+
+TEST(TestSuite, Nested)
+{
+	// workers wait for nested loops by working on them
+	ThreadPool pool(4);
+	std::atomic<int> count = 0;
+	pool.parallelFor(16, 1, [&](size_t, size_t)
+	{
+		pool.parallelFor(100, 10, [&](size_t begin, size_t end)
+		{
+			count += int(end - begin);
+		});
+	});
+	EXPECT_EQ(count, 1600);
+}
+
+TEST(TestSuite, Exception)
+{
+	ThreadPool pool(4);
+	EXPECT_THROW(pool.parallelFor(100, 1, [](size_t begin, size_t)
+	{
+		if (begin == 50)
+			throw std::runtime_error("chunk failed");
+	}), std::runtime_error);
+
+	// the pool is still usable
+	std::atomic<int> count = 0;
+	pool.parallelFor(100, 1, [&](size_t, size_t) { ++count; });
+	EXPECT_EQ(count, 100);
+}
@@ -473,4 +473,25 @@ TEST(TestSuite, FromArray)
 	EXPECT_EQ(v2.size(), 2);
 	EXPECT_EQ(v2[0], std::string("45"));
 	EXPECT_EQ(v2[1], std::string("32"));
-}
\ No newline at end of file
+}
+TEST(TestSuite, NumberConversion)
+{
+	EXPECT_EQ(Util::numberToString(-42), "-42");
+	EXPECT_EQ(Util::numberToString(2.0f), "2.0");
+	EXPECT_EQ(Util::numberToString(0.1f), "0.1");
+	EXPECT_EQ(Util::numberToString(1e20f), "1e+20");
+	// shortest representation round-trips
+	const float value = 1.0f / 3.0f;
+	EXPECT_EQ(Util::parseNumber<float>(Util::numberToString(value)), value);
+
+	EXPECT_EQ(Util::parseNumber<int>(" +12"), 12);
+	EXPECT_EQ(Util::parseNumber<float>("2.5f"), 2.5f);
+	EXPECT_THROW(Util::parseNumber<int>("abc"), std::invalid_argument);
+	EXPECT_THROW(Util::parseNumber<int>("+-1"), std::invalid_argument);
+	EXPECT_THROW(Util::parseNumber<int>("99999999999"), std::out_of_range);
+
+	ScriptEngine engine;
+	EXPECT_EQ(engine.execute("3.5f")->toString(), "3.5");
+	EXPECT_EQ(engine.execute("Int(\"17\")")->toString(), "17");
+	EXPECT_EQ(engine.execute("FloatArray([1.0f, 0.25f])")->toString(), "[1.0, 0.25]");
+}
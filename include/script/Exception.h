@@ -81,4 +81,19 @@ namespace script
 	public:
 		explicit BracketMismatch(size_t position, const std::string& expected, const std::string& found);
 	};
+
+	/// \brief the engine stopped the execution because of its step limit, deadline or cancel().
+	/// The tokens and the file functions pass it on without adding position information
+	class ExecutionAbortedException final : public Exception
+	{
+	public:
+		enum class Reason
+		{
+			StepLimit,
+			Deadline,
+			Cancelled
+		};
+		explicit ExecutionAbortedException(Reason reason);
+		const Reason reason;
+	};
 }
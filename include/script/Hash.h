@@ -0,0 +1,70 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <iterator>
+#include <type_traits>
+
+namespace script::hash
+{
+	/// \brief mixes hash into seed (order dependent)
+	inline size_t combine(size_t seed, size_t hash)
+	{
+		return seed ^ (hash + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+	}
+
+	/// \brief hash that is consistent with operator== of T
+	template<class T>
+	size_t value(const T& v)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			// 0.0 and -0.0 are equal
+			return v == T(0) ? 0 : std::hash<T>()(v);
+		}
+		else
+		{
+			return std::hash<T>()(v);
+		}
+	}
+
+	inline size_t value(const std::string& v)
+	{
+		return std::hash<std::string_view>()(v);
+	}
+
+	inline size_t value(std::string_view v)
+	{
+		return std::hash<std::string_view>()(v);
+	}
+
+	template<class Rep, class Period>
+	size_t value(const std::chrono::duration<Rep, Period>& v)
+	{
+		return value(v.count());
+	}
+
+	template<class Clock, class Duration>
+	size_t value(const std::chrono::time_point<Clock, Duration>& v)
+	{
+		return value(v.time_since_epoch());
+	}
+
+	/// \brief order dependent hash of [first, last)
+	template<class It>
+	size_t range(It first, It last)
+	{
+		size_t res = size_t(std::distance(first, last));
+		for (; first != last; ++first)
+			res = combine(res, value(*first));
+		return res;
+	}
+
+	template<class T, class A>
+	size_t value(const std::vector<T, A>& v)
+	{
+		return range(v.begin(), v.end());
+	}
+}
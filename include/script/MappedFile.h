@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace script
+{
+	/// \brief read only memory mapping of a file. The operating system loads the pages on access,
+	/// so large files are not copied into memory at once
+	class MappedFile
+	{
+	public:
+		/// \throws runtime_error if the file can not be opened or mapped
+		explicit MappedFile(const std::string& filename);
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// \brief contents of the file (valid until the MappedFile is destroyed)
+		std::string_view getData() const
+		{
+			return std::string_view(m_data, m_size);
+		}
+	private:
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+		// file mapping object (only used on windows)
+		void* m_mapping = nullptr;
+	};
+}
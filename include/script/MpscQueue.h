@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+namespace script
+{
+	/// \brief unbounded lock free queue for multiple producers and a single consumer.
+	/// push only needs one atomic exchange. A pop may fail for a short time while a producer links its element
+	template<class T>
+	class MpscQueue
+	{
+	public:
+		MpscQueue()
+			:
+		m_head(new Node),
+		m_tail(m_head.load())
+		{}
+
+		~MpscQueue()
+		{
+			T value;
+			while (pop(value)) {}
+			delete m_tail;
+		}
+
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+
+		/// \brief may be called from any thread
+		void push(T value)
+		{
+			const auto node = new Node;
+			node->value = std::move(value);
+			const auto prev = m_head.exchange(node, std::memory_order_acq_rel);
+			prev->next.store(node, std::memory_order_release);
+		}
+
+		/// \brief may only be called from the consumer thread
+		/// \return false if no (completely linked) element is available
+		bool pop(T& value)
+		{
+			const auto next = m_tail->next.load(std::memory_order_acquire);
+			if (next == nullptr) return false;
+
+			// next becomes the new empty head node
+			value = std::move(next->value);
+			delete m_tail;
+			m_tail = next;
+			return true;
+		}
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next{ nullptr };
+			T value;
+		};
+
+		// last pushed node (producers)
+		std::atomic<Node*> m_head;
+		// empty node before the first element (consumer)
+		Node* m_tail;
+	};
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+
+namespace script::kernels
+{
+	/// \brief instruction sets that can be used by the kernels
+	enum class InstructionSet
+	{
+		Scalar,
+		// SSE 4.1 (4 elements per instruction)
+		SSE41,
+		// AVX2 (8 elements per instruction)
+		AVX2
+	};
+
+	/// \brief returns the instruction set that is used by the kernels.
+	/// The best supported instruction set is determined once at runtime
+	InstructionSet getInstructionSet();
+
+	/// \brief returns the best instruction set that is supported by the cpu
+	InstructionSet getSupportedInstructionSet();
+
+	/// \brief sets the instruction set that is used by the kernels (will be limited to the supported instruction set)
+	void setInstructionSet(InstructionSet set);
+
+	// dst[i] += value (or src[i])
+	void add(float* dst, float value, size_t count);
+	void add(float* dst, const float* src, size_t count);
+	void add(int* dst, int value, size_t count);
+	void add(int* dst, const int* src, size_t count);
+
+	// dst[i] -= value (or src[i])
+	void subtract(float* dst, float value, size_t count);
+	void subtract(float* dst, const float* src, size_t count);
+	void subtract(int* dst, int value, size_t count);
+	void subtract(int* dst, const int* src, size_t count);
+
+	// dst[i] *= value (or src[i])
+	void multiply(float* dst, float value, size_t count);
+	void multiply(float* dst, const float* src, size_t count);
+	void multiply(int* dst, int value, size_t count);
+	void multiply(int* dst, const int* src, size_t count);
+
+	// dst[i] /= value (or src[i]). The integer versions do not check for zero
+	void divide(float* dst, float value, size_t count);
+	void divide(float* dst, const float* src, size_t count);
+	void divide(int* dst, int value, size_t count);
+	void divide(int* dst, const int* src, size_t count);
+
+	// dst[i] = -dst[i]
+	void negate(float* dst, size_t count);
+	void negate(int* dst, size_t count);
+
+	// dst[i] = |dst[i]|
+	void abs(float* dst, size_t count);
+	void abs(int* dst, size_t count);
+
+	// dst[i] = min(max(dst[i], low), high)
+	void clamp(float* dst, float low, float high, size_t count);
+	void clamp(int* dst, int low, int high, size_t count);
+
+	// dst[i] = dst[i] * mul + add (fused for floats if supported)
+	void multiplyAdd(float* dst, float mul, float add, size_t count);
+	void multiplyAdd(int* dst, int mul, int add, size_t count);
+	// dst[i] = dst[i] * mul[i] + add[i] (fused for floats if supported)
+	void multiplyAdd(float* dst, const float* mul, const float* add, size_t count);
+	void multiplyAdd(int* dst, const int* mul, const int* add, size_t count);
+
+	// sum of all elements (pairwise summation for floats to reduce the rounding error)
+	float sum(const float* src, size_t count);
+	long long sum(const int* src, size_t count);
+
+	// smallest and largest element (count must be greater than zero). NaN values are ignored. Returns NaN if all values are NaN
+	float minimum(const float* src, size_t count);
+	int minimum(const int* src, size_t count);
+	float maximum(const float* src, size_t count);
+	int maximum(const int* src, size_t count);
+
+	// sum of (src[i] - mean)^2 (pairwise summation)
+	float sumSquaredDeviation(const float* src, float mean, size_t count);
+	float sumSquaredDeviation(const int* src, float mean, size_t count);
+}
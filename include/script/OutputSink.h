@@ -0,0 +1,63 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <ostream>
+
+namespace script
+{
+	/// \brief receives the text of ScriptObject::writeTo. Text beyond the size limit is discarded
+	class OutputSink
+	{
+	public:
+		/// \param limit maximum number of characters that will be forwarded
+		explicit OutputSink(size_t limit = size_t(-1));
+		virtual ~OutputSink() = default;
+
+		/// \brief forwards the text (truncated if the limit is exceeded)
+		/// \return false if the sink is full
+		bool write(std::string_view text);
+		bool write(char c);
+
+		/// \brief indicates that further text will be discarded. Writers may stop early
+		bool isFull() const;
+		/// \brief indicates that text was discarded
+		bool isTruncated() const;
+		/// \brief marks the output as truncated. Called by writers that stop early because the sink is full
+		void setTruncated();
+		/// \brief number of forwarded characters
+		size_t getSize() const;
+		size_t getLimit() const;
+	protected:
+		virtual void onWrite(std::string_view text) = 0;
+	private:
+		size_t m_limit;
+		size_t m_size = 0;
+		bool m_truncated = false;
+	};
+
+	/// \brief collects the text in a string
+	class StringSink final : public OutputSink
+	{
+	public:
+		explicit StringSink(size_t limit = size_t(-1));
+
+		const std::string& getString() const;
+		/// \brief moves the string out of the sink
+		std::string release();
+	protected:
+		void onWrite(std::string_view text) override;
+	private:
+		std::string m_string;
+	};
+
+	/// \brief forwards the text to a stream
+	class StreamSink final : public OutputSink
+	{
+	public:
+		explicit StreamSink(std::ostream& stream, size_t limit = size_t(-1));
+	protected:
+		void onWrite(std::string_view text) override;
+	private:
+		std::ostream& m_stream;
+	};
+}
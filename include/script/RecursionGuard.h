@@ -0,0 +1,30 @@
+#pragma once
+
+namespace script
+{
+	/// \brief marks an object as visited on the current thread until the guard is destroyed.
+	/// Stops the recursion of toString or hashCode if a container contains itself. Unlike the BoolMutex
+	/// the state is kept per thread, so several threads may print or hash the same object at once
+	class RecursionGuard
+	{
+	public:
+		enum class Operation
+		{
+			ToString,
+			HashCode
+		};
+
+		RecursionGuard(const void* object, Operation operation);
+		~RecursionGuard();
+		RecursionGuard(const RecursionGuard&) = delete;
+		RecursionGuard& operator=(const RecursionGuard&) = delete;
+
+		/// \brief true if the object is already visited by an outer guard of this thread
+		bool isRecursive() const
+		{
+			return m_recursive;
+		}
+	private:
+		bool m_recursive;
+	};
+}
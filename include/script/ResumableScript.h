@@ -0,0 +1,75 @@
+#pragma once
+#include "ScriptEngine.h"
+#include "StatementReader.h"
+
+namespace script
+{
+	/// \brief script that is executed statement by statement and can be suspended between two top-level statements.
+	/// One thread can multiplex many scripts by resuming each of them with a small budget.
+	/// A single statement always runs to completion: a long evaluation inside one statement (e.g. IO.executeFile or
+	/// Engine.execute) blocks the thread until it returns. Use ScriptEngine::setStepLimit or setDeadline to bound it
+	class ResumableScript
+	{
+	public:
+		static constexpr size_t Unlimited = size_t(-1);
+
+		enum class State
+		{
+			Suspended,
+			Finished
+		};
+
+		/// \param engine must outlive the script
+		/// \param script statements that end with a semicolon
+		ResumableScript(ScriptEngine& engine, std::string script);
+		ResumableScript(const ResumableScript&) = delete;
+		ResumableScript& operator=(const ResumableScript&) = delete;
+
+		/// \brief executes statements until the script ended, the statements used at least budget engine steps
+		/// (ScriptEngine::getStepCount) or a statement called System.yield(). Steps and yields of nested executions
+		/// (e.g. Engine.execute) count as well, but the script is only suspended after the current top-level statement.
+		/// Errors are thrown with the line of the statement and finish the script
+		State resume(size_t budget = Unlimited);
+
+		State getState() const
+		{
+			return m_state;
+		}
+
+		bool isFinished() const
+		{
+			return m_state == State::Finished;
+		}
+
+		/// \brief result of the last executed statement (NullObject before the first statement)
+		const ScriptObjectPtr& getResult() const
+		{
+			return m_result;
+		}
+
+		/// \brief number of executed statements
+		size_t getExecutedCount() const
+		{
+			return m_executed;
+		}
+
+		/// \brief suspends the script that is resumed on this thread after the current top-level statement.
+		/// Returns false if no script is resumed on this thread
+		static bool yield();
+	private:
+		// statements that are read at once
+		static constexpr size_t ChunkSize = 64;
+
+		ScriptEngine& m_engine;
+		// the statements are views into the script
+		std::string m_script;
+		StatementReader m_reader;
+		std::vector<StatementReader::Statement> m_statements;
+		// next statement of m_statements
+		size_t m_next = 0;
+		size_t m_executed = 0;
+		ScriptObjectPtr m_result;
+		State m_state = State::Suspended;
+		bool m_yield = false;
+	};
+}
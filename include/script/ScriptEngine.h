@@ -1,6 +1,16 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <span>
+#include <memory>
 #include <unordered_map>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
 #include "objects/ScriptObject.h"
 #include "objects/ArrayObject.h"
 #include "objects/IntObject.h"
@@ -9,10 +19,15 @@
 #include "objects/BoolObject.h"
 #include "objects/EnumObject.h"
 #include "Util.h"
+#include "StringTable.h"
+#include "ThreadPool.h"
 #include <unordered_set>
 
 namespace script
 {
+	class L2Token;
+	class ResumableScript;
+
 	class ScriptEngine
 	{
 	public:
@@ -35,12 +50,119 @@ namespace script
 			All = 0xFFFFFFFF
 		};
 
-		explicit ScriptEngine(InitFlags flags = All);
+		enum class Threading
+		{
+			// the engine is used by one thread at a time (no locking)
+			SingleThreaded,
+			// execute and the object functions may be called from several threads at once.
+			// The variable store is sharded and locked, the statics are read from an immutable snapshot.
+			// Objects that are shared between threads (e.g. the same variable) are not synchronized
+			Concurrent
+		};
+
+		explicit ScriptEngine(InitFlags flags = All, Threading threading = Threading::SingleThreaded);
+		/// \brief waits for the commands of executeAsync
+		~ScriptEngine();
+		ScriptEngine(const ScriptEngine&) = delete;
+		ScriptEngine& operator=(const ScriptEngine&) = delete;
+
+		/// \brief makes this engine a read only prototype for fork().
+		/// Afterwards execute and all functions that modify variables or statics throw
+		void freeze();
+
+		bool isFrozen() const
+		{
+			return m_frozen;
+		}
+
+		/// \brief creates an engine that shares the statics of this frozen engine by pointer (IO and Engine are bound to the new engine).
+		/// The variables of the prototype are copied into the fork when they are accessed for the first time
+		/// \throws runtime_error if the engine is not frozen
+		std::unique_ptr<ScriptEngine> fork() const;
 
 		/// \brief executes the given command and returns the result
 		/// \param command command to execute
 		ScriptObjectPtr execute(const std::string& command);
 
+		/// \brief command that was parsed by compile
+		struct CompiledCommand
+		{
+			// the command (used for error messages). Points into storage or into the source of the caller
+			std::string_view text;
+			// owns the text if it was copied by compile (shared: copies of the command keep the view valid)
+			std::shared_ptr<const std::string> storage;
+			// nullptr for empty commands
+			std::shared_ptr<const L2Token> token;
+		};
+
+		/// \brief parses the command without executing it. String literals are interned in the string table of this engine
+		/// \param copyText false: the text is not copied and command must outlive the returned CompiledCommand
+		/// (e.g. a statement of a mapped script file)
+		/// \throws runtime_error with the position of the syntax error
+		CompiledCommand compile(std::string_view command, bool copyText = true);
+
+		/// \brief executes a compiled command (may be executed several times)
+		ScriptObjectPtr execute(const CompiledCommand& command);
+
+		/// \brief result of one command of executeBatch. value and error are nullptr if the command was not executed
+		struct BatchResult
+		{
+			ScriptObjectPtr value;
+			// syntax or execution error
+			std::exception_ptr error;
+		};
+
+		enum class BatchPolicy
+		{
+			// the commands after the first error are not executed
+			StopOnError,
+			ContinueOnError
+		};
+
+		/// \brief compiles all commands (on the thread pool if parallelCompile is set) and executes them in order.
+		/// Returns one result per command
+		std::vector<BatchResult> executeBatch(std::span<const std::string> commands, BatchPolicy policy = BatchPolicy::StopOnError, bool parallelCompile = false);
+
+		/// \brief executes the command on a worker thread of ScriptExecutor::getDefault().
+		/// The commands of one engine are executed in submission order. The future rethrows the exceptions of execute.
+		/// Other calls to the engine must not run at the same time unless the engine is concurrent
+		std::future<ScriptObjectPtr> executeAsync(std::string command);
+
+		/// \brief executes the statements of the script until they used budget steps (function calls and operators, see
+		/// getStepCount) or a statement called System.yield(). The script is only suspended between two top-level statements
+		/// (see ResumableScript::resume). The returned script continues with resume() and must not outlive the engine
+		std::unique_ptr<ResumableScript> executeResumable(std::string script, size_t budget = size_t(-1));
+
+		static constexpr uint64_t NoStepLimit = uint64_t(-1);
+
+		/// \brief aborts the execution with an ExecutionAbortedException after steps further function calls and operators.
+		/// NoStepLimit removes the limit
+		void setStepLimit(uint64_t steps);
+
+		/// \brief aborts the execution with an ExecutionAbortedException after the deadline (time_point::max() removes the deadline)
+		void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+		/// \brief aborts the current and all following executions with an ExecutionAbortedException at their next step
+		/// (may be called from any thread). The engine stays cancelled until resetLimits()
+		void cancel();
+
+		/// \brief removes the step limit, the deadline and the cancellation
+		void resetLimits();
+
+		/// \brief number of executed function calls and operators (approximate if several threads execute)
+		uint64_t getStepCount() const;
+
+		/// \brief counts a function call or operator. The limits are checked every StepCheckInterval steps
+		void step()
+		{
+			// no atomic decrement: steps of concurrent threads may be lost but the fast path stays a plain load and store
+			const auto remaining = m_stepCountdown.load(std::memory_order_relaxed) - 1;
+			m_stepCountdown.store(remaining, std::memory_order_relaxed);
+			// the store may overwrite the countdown that cancel() set to zero => the flag is tested as well
+			if (remaining <= 0 || m_cancelled.load(std::memory_order_relaxed))
+				checkLimits();
+		}
+
 		/// \brief retrieves the object with the given name
 		/// \param object name
 		/// \return pointer to the object or nullptr if not found
@@ -84,29 +206,120 @@ namespace script
 		/// \param function valid function
 		void setStaticFunction(const std::string& name, const ScriptObject::FunctionT& function);
 
-		const auto& getObjects() const
+		using ObjectMap = std::unordered_map<std::string, ScriptObjectPtr>;
+		using FunctionMap = std::unordered_map<std::string, ScriptObject::FunctionT>;
+
+		/// \brief copy of all variables
+		ObjectMap getObjects() const;
+
+		/// \brief snapshot of the static objects (later changes are not visible in the snapshot)
+		std::shared_ptr<const ObjectMap> getStaticObjects() const;
+
+		/// \brief snapshot of the static functions (later changes are not visible in the snapshot)
+		std::shared_ptr<const FunctionMap> getStaticFunctions() const;
+
+		bool isConcurrent() const
 		{
-			return m_objects;
+			return m_threading == Threading::Concurrent;
 		}
 
-		const auto& getStaticObjects() const
+		/// \brief table of the interned string literals
+		StringTable& getStringTable()
 		{
-			return m_staticObjects;
+			return m_strings;
 		}
 
-		const auto& getStaticFunctions() const
+		/// \brief pool that is used by the parallel array functions during execute (the threads are started on first use)
+		ThreadPool& getThreadPool()
 		{
-			return m_staticFunctions;
+			return m_threadPool;
 		}
 
 		/// \brief retrieves a list of all possible auto-completions regarding to the text
 		std::vector<std::string> getAutocomplete(const std::string& text);
 	private:
+		// the executor counts the pending commands of the engine
+		friend class ScriptExecutor;
+
+		struct ForkTag {};
+		ScriptEngine(const ScriptEngine& prototype, ForkTag);
+
 		static void addAllFunctions(std::unordered_set<std::string>& set, const ScriptObject& obj);
+		/// \brief error message with the position of the error in the command
+		static std::runtime_error getError(std::string_view command, const ParseError& error);
+		void throwIfFrozen(const char* function) const;
+		bool hasPrototypeObject(const std::string& name) const;
+		/// \brief copies the prototype variable into the variables of this engine.
+		/// Each prototype object is cloned once, so variables that alias it in the prototype alias the clone
+		ScriptObjectPtr copyPrototypeObject(const std::string& name) const;
+		/// \brief throws if a limit was exceeded and restarts the step countdown
+		void checkLimits();
+		/// \brief adds the steps of the current countdown to m_stepCount (m_limitMutex must be locked)
+		void updateStepCount();
+		/// \brief counts down to the next check or to the step limit (m_limitMutex must be locked)
+		void restartCountdown();
+		void beginAsync();
+		void endAsync();
+		/// \brief unique number of the engine (the executor pins the engine to a worker with it)
+		size_t getId() const
+		{
+			return m_id;
+		}
+
+		static constexpr size_t ShardCount = 16;
+		// commands per task of the parallel compilation
+		static constexpr size_t CompileGrainSize = 32;
+		// steps between two checks of the cancellation and the deadline
+		static constexpr int64_t StepCheckInterval = 1024;
+		struct Shard
+		{
+			mutable std::shared_mutex mutex;
+			ObjectMap objects;
+		};
+
+		Shard& getShard(const std::string& name) const;
+		/// \brief locks the shard if the engine is concurrent
+		std::shared_lock<std::shared_mutex> readLock(const Shard& shard) const;
+		std::unique_lock<std::shared_mutex> writeLock(Shard& shard) const;
+
+		/// \brief replaces the snapshot with a modified copy (read-copy-update). Readers keep their old snapshot
+		template<class TMap, class TFunc>
+		void updateSnapshot(std::atomic<std::shared_ptr<const TMap>>& snapshot, TFunc modify);
+		template<class TMap>
+		static std::shared_ptr<const TMap> loadSnapshot(const std::atomic<std::shared_ptr<const TMap>>& snapshot);
 
-		std::unordered_map<std::string, ScriptObjectPtr> m_objects;
-		std::unordered_map<std::string, ScriptObjectPtr> m_staticObjects;
-		std::unordered_map<std::string, ScriptObject::FunctionT> m_staticFunctions;
+		InitFlags m_flags;
+		size_t m_id;
+		Threading m_threading;
+		bool m_frozen = false;
+		// variables of this engine. nullptr hides a prototype variable.
+		// mutable: prototype variables are copied on access
+		mutable std::array<Shard, ShardCount> m_shards;
+		// variables of the frozen prototype (nullptr if the engine was not forked)
+		std::shared_ptr<const ObjectMap> m_prototypeObjects;
+		// clone of each prototype object that was copied into the fork (variables that alias an object share its clone)
+		mutable std::unordered_map<const ScriptObject*, ScriptObjectPtr> m_prototypeClones;
+		mutable std::mutex m_prototypeMutex;
+		std::atomic<std::shared_ptr<const ObjectMap>> m_staticObjects;
+		std::atomic<std::shared_ptr<const FunctionMap>> m_staticFunctions;
+		// serializes the writers of the snapshots
+		std::mutex m_staticMutex;
+		StringTable m_strings;
+		ThreadPool m_threadPool;
+		// number of commands in the ScriptExecutor
+		size_t m_asyncPending = 0;
+		std::mutex m_asyncMutex;
+		std::condition_variable m_asyncDone;
+		// steps until the next checkLimits
+		std::atomic<int64_t> m_stepCountdown{ StepCheckInterval };
+		// start value of the countdown
+		int64_t m_countdownStart = StepCheckInterval;
+		// steps before the current countdown
+		uint64_t m_stepCount = 0;
+		uint64_t m_stepLimit = NoStepLimit;
+		std::chrono::steady_clock::time_point m_deadline = std::chrono::steady_clock::time_point::max();
+		std::atomic<bool> m_cancelled{ false };
+		mutable std::mutex m_limitMutex;
 	};
 
 	template <class T>
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <future>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Script.h"
+#include "MpscQueue.h"
+
+namespace script
+{
+	class ScriptEngine;
+
+	/// \brief worker threads that execute commands of script engines asynchronously.
+	/// Every engine is pinned to one worker, so the commands of an engine are executed in submission order
+	/// and an engine never runs on two workers at once
+	class ScriptExecutor
+	{
+	public:
+		/// \param threadCount number of workers (0 = number of hardware threads)
+		explicit ScriptExecutor(size_t threadCount = 0);
+		/// \brief executes the remaining commands and stops the workers
+		~ScriptExecutor();
+		ScriptExecutor(const ScriptExecutor&) = delete;
+		ScriptExecutor& operator=(const ScriptExecutor&) = delete;
+
+		/// \brief queues engine.execute(command). The engine must stay alive until the command is done
+		/// (the destructor of the ScriptEngine waits for its commands)
+		std::future<ScriptObjectPtr> submit(ScriptEngine& engine, std::string command);
+
+		size_t getThreadCount() const;
+
+		/// \brief executor that is used by ScriptEngine::executeAsync
+		static ScriptExecutor& getDefault();
+	private:
+		struct Task
+		{
+			ScriptEngine* engine = nullptr;
+			std::string command;
+			std::promise<ScriptObjectPtr> result;
+		};
+
+		struct Worker
+		{
+			MpscQueue<Task> queue;
+			// number of pushed tasks that were not taken by the worker
+			std::atomic<size_t> pending{ 0 };
+			std::mutex mutex;
+			std::condition_variable wake;
+			bool stop = false;
+			std::thread thread;
+		};
+
+		static void work(Worker& worker);
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+	};
+}
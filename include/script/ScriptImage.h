@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "ScriptEngine.h"
+#include "MappedFile.h"
+
+namespace script
+{
+	class L2Token;
+
+	namespace image
+	{
+		enum class NodeType : uint8_t
+		{
+			ArgumentList,
+			Function,
+			IdentifierAssign,
+			Identifier,
+			StaticIdentifier,
+			StaticFunction,
+			Operator,
+			PropertyGetter,
+			PropertySetter,
+			String,
+			Int,
+			Float,
+			Bool,
+			Null,
+			Count
+		};
+
+		/// \brief flattened token. Children are node indices (always smaller than the index of the parent), names are string indices
+		struct Node
+		{
+			NodeType type;
+			// operator: object is cloned before the operator is invoked
+			uint8_t clone;
+			uint16_t reserved;
+			uint32_t position;
+			uint32_t a;
+			uint32_t b;
+			uint32_t c;
+			uint32_t d;
+		};
+
+		// missing child
+		constexpr uint32_t None = 0xFFFFFFFF;
+
+		/// \brief start of the image. The offsets are relative to the start of the file
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t stringCount;
+			uint32_t stringOffset;
+			uint32_t nodeCount;
+			uint32_t nodeOffset;
+			uint32_t listCount;
+			uint32_t listOffset;
+			uint32_t statementCount;
+			uint32_t statementOffset;
+			uint32_t staticCount;
+			uint32_t staticOffset;
+		};
+	}
+
+	/// \brief collects the compiled statements of a script and saves them as image
+	class ScriptImageWriter
+	{
+	public:
+		/// \brief adds the token and its children. Returns the node index or image::None for nullptr
+		uint32_t add(const L2Token* token);
+		uint32_t addNode(image::NodeType type, size_t position, uint32_t a = image::None, uint32_t b = image::None,
+			uint32_t c = image::None, uint32_t d = image::None, bool clone = false);
+		/// \brief returns the index in the string table (equal strings are stored once)
+		uint32_t addString(std::string_view value);
+		/// \brief stores the indices consecutively. Returns the index of the first value
+		uint32_t addList(const std::vector<uint32_t>& values);
+		void addStatement(const L2Token* token, size_t line, std::string_view text);
+		/// \brief the image can only be executed by engines with the same static objects and functions
+		void setStatics(const ScriptEngine& engine);
+
+		void save(const std::string& filename) const;
+	private:
+		struct Statement
+		{
+			uint32_t node;
+			uint32_t line;
+			uint32_t text;
+		};
+
+		std::vector<image::Node> m_nodes;
+		std::vector<uint32_t> m_lists;
+		std::vector<std::string_view> m_strings;
+		// owns the strings of the table
+		std::unordered_map<std::string, uint32_t> m_stringIndices;
+		std::vector<Statement> m_statements;
+		std::vector<uint32_t> m_statics;
+	};
+
+	/// \brief precompiled script file that can be executed without parsing.
+	/// The image contains a string table, the flattened tokens of all statements and the line of every statement
+	class ScriptImage
+	{
+	public:
+		/// \brief changes whenever the format or the tokens change
+		static constexpr uint32_t Version = 1;
+
+		/// \brief compiles the statements of the script file (separated by ;) and saves the image
+		/// \throws runtime_error with the line of the first syntax error
+		static void compileFile(const ScriptEngine& engine, const std::string& scriptFile, const std::string& imageFile);
+
+		/// \brief maps the image into memory
+		/// \throws runtime_error if the image is invalid, has a different version or was compiled for different statics than the engine has
+		ScriptImage(const std::string& filename, const ScriptEngine& engine);
+
+		size_t getStatementCount() const;
+		size_t getLine(size_t statement) const;
+		/// \brief creates the tokens of the statement. String literals are interned in the table of the engine.
+		/// The text of the command points into the image (valid while the image exists)
+		ScriptEngine::CompiledCommand getCommand(size_t statement, ScriptEngine& engine) const;
+
+		/// \brief sorted names of the static objects and functions of the engine (functions end with "(")
+		static std::vector<std::string> getStaticNames(const ScriptEngine& engine);
+	private:
+		void verify() const;
+		void verifyStatics(const ScriptEngine& engine) const;
+		template<class T>
+		T read(size_t offset) const;
+		std::string_view getString(uint32_t index) const;
+		image::Node getNode(uint32_t index) const;
+		std::unique_ptr<L2Token> getToken(uint32_t index, StringTable& strings) const;
+
+		std::string m_filename;
+		MappedFile m_file;
+		image::Header m_header;
+	};
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace script
+{
+	/// \brief splits a script text at the semicolons (outside of comments) without copying the statements
+	class StatementReader
+	{
+	public:
+		struct Statement
+		{
+			// line of the first character
+			size_t line = 0;
+			// view into the text
+			std::string_view view;
+			// copy of the statement without comments (only used for statements with comments)
+			std::string copy;
+			bool isCopy = false;
+
+			std::string_view getCommand() const
+			{
+				return isCopy ? std::string_view(copy) : view;
+			}
+		};
+
+		/// \param text must stay valid while the statements are used
+		explicit StatementReader(std::string_view text);
+
+		/// \brief replaces the statements with the next (at most maxCount) statements. Returns false at the end of the text
+		bool read(std::vector<Statement>& statements, size_t maxCount);
+
+		/// \brief true if the text ended with a statement without semicolon
+		bool hasRemainder() const
+		{
+			return m_remainder;
+		}
+	private:
+		bool readStatement(Statement& s);
+
+		std::string_view m_text;
+		size_t m_pos = 0;
+		size_t m_line = 1;
+		bool m_remainder = false;
+	};
+}
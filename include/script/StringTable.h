@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace script
+{
+	/// \brief thread safe table of immutable strings. Equal strings share one payload
+	class StringTable
+	{
+	public:
+		using StringPtr = std::shared_ptr<const std::string>;
+
+		/// \brief returns the shared payload for value (creates it if it does not exist)
+		StringPtr intern(std::string_view value);
+		/// \brief number of strings in the table
+		size_t size() const;
+		/// \brief removes all strings that are only referenced by the table
+		void collect();
+	private:
+		void collectUnlocked();
+
+		mutable std::mutex m_mutex;
+		// the key references the payload of the value
+		std::unordered_map<std::string_view, StringPtr> m_strings;
+		// collect() will be called when this size is reached
+		size_t m_collectSize = 64;
+	};
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace script
+{
+	/// \brief work stealing thread pool. Each worker owns a task queue and steals from the other queues if its own queue is empty.
+	/// The worker threads are started with the first parallel call
+	class ThreadPool
+	{
+	public:
+		/// \param threadCount number of threads including the calling thread (0 = number of hardware threads)
+		explicit ThreadPool(size_t threadCount = 0);
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/// \brief number of threads that work on a parallelFor (including the calling thread)
+		size_t getThreadCount() const;
+
+		/// \brief calls func(begin, end) for chunks of [0, count) with at most grainSize elements.
+		/// The calling thread works on the chunks as well. Blocks until all chunks are done and rethrows the first exception
+		void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func);
+
+		/// \brief pool of the ScriptEngine that executes on this thread or nullptr
+		static ThreadPool* getCurrent();
+
+		/// \brief sets the current pool of this thread until the scope ends
+		class Scope
+		{
+		public:
+			explicit Scope(ThreadPool* pool);
+			~Scope();
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		private:
+			ThreadPool* m_previous;
+		};
+	private:
+		using Task = std::function<void()>;
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void start();
+		void work(size_t index);
+		/// \brief takes the newest task of the own queue or steals the oldest task of another queue
+		bool pop(size_t index, Task& task);
+		void push(size_t index, Task task);
+
+		size_t m_threadCount;
+		// one queue per worker and one for the threads that are not part of the pool
+		std::vector<std::unique_ptr<Queue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::once_flag m_started;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::atomic<size_t> m_pending{ 0 };
+		bool m_stop = false;
+	};
+}
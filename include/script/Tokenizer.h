@@ -1,8 +1,10 @@
 #pragma once
 #include <vector>
+#include <string_view>
 #include "tokens/L1Token.h"
 #include <memory>
 #include "tokens/L2Token.h"
+#include "StringTable.h"
 
 namespace script
 {
@@ -30,19 +32,20 @@ namespace script
 
 		Tokenizer() = delete;
 
-		static std::unique_ptr<L2Token> getExecutable(const std::string& command);
+		/// \brief parses the command. String literals will be interned in strings (if not null)
+		static std::unique_ptr<L2Token> getExecutable(std::string_view command, StringTable* strings = nullptr);
 
 		static AutocompleteInfo getAutocomplete(const std::string& command);
 
-		static std::vector<L1Token> getL1Tokens(const std::string& command, bool throwExceptions = true);
+		static std::vector<L1Token> getL1Tokens(std::string_view command, bool throwExceptions = true);
 		static void applyL1Rules(std::vector<L1Token>& tokens);
 		static void verifyBrackets(const std::vector<L1Token>& tokens);
-		static std::unique_ptr<L2Token> getL2Tokens(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, bool isArgumentList, OpReturnMode mode);
+		static std::unique_ptr<L2Token> getL2Tokens(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, bool isArgumentList, OpReturnMode mode, StringTable* strings = nullptr);
 
 	private:
-		static std::unique_ptr<L2Token> parseArgumentList(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, L1Token::Type endToken, const std::string& type);
+		static std::unique_ptr<L2Token> parseArgumentList(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, L1Token::Type endToken, const std::string& type, StringTable* strings);
 		static void handleOperatorAssign(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, 
-			std::unique_ptr<L2Token>& curToken, bool isArgumentList, std::string funcName, std::string opName);
+			std::unique_ptr<L2Token>& curToken, bool isArgumentList, std::string funcName, std::string opName, StringTable* strings);
 		static char getEscapedChar(size_t position, char value);
 
 		static void fillAutocompleteCaller(const std::vector<L1Token>& tokens, AutocompleteInfo& info);
@@ -1,12 +1,18 @@
 #pragma once
 #include "objects/ScriptObject.h"
 #include "objects/ArrayObject.h"
+#include "objects/MapObject.h"
 #include "objects/ValueObject.h"
 #include "Exception.h"
 #include <sstream>
 #include "objects/NullObject.h"
 #include <set>
+#include <unordered_map>
 #include <algorithm>
+#include <charconv>
+#include <string_view>
+#include <cctype>
+#include <cmath>
 
 namespace script
 {
@@ -150,6 +156,24 @@ namespace script
 
 #pragma endregion
 
+		/// \brief function object that marks a function as pure (see makePure)
+		struct PureFunction
+		{
+			ScriptObject::FunctionT func;
+			ScriptObjectPtr operator()(const ArrayObjectPtr& args) const
+			{
+				return func(args);
+			}
+		};
+
+		/// \brief marks the function as pure: it only reads its arguments and only reads or modifies the object it is registered on.
+		/// Pure functions of different objects may run on multiple threads at the same time (ArrayObject::parallelInvokeAll...)
+		/// Usage: addFunction("add", Util::makePure(Util::makeFunction(...)))
+		static ScriptObject::FunctionT makePure(ScriptObject::FunctionT func)
+		{
+			return PureFunction{ std::move(func) };
+		}
+
 		/// \brief merges multiple functions into one.
 		/// The functions will be called in order up to the first function that does not throw an
 		/// InvalidArgumentCount or InvalidArgumentType exception.
@@ -229,6 +253,26 @@ namespace script
 			return std::make_shared<ArrayObject>(res);
 		}
 
+		/// \brief converts an std unordered_map into a map object
+		/// \tparam TKey, TValue must be convertible to a ScriptObject or have an appropriate makeObject function
+		template<class TKey, class TValue, class THash, class TEqual, class TAlloc>
+		static MapObjectPtr makeObject(const std::unordered_map<TKey, TValue, THash, TEqual, TAlloc>& map)
+		{
+			auto res = std::make_shared<MapObject>();
+			res->reserve(int(map.size()));
+			for (const auto& e : map)
+			{
+				res->set(Util::makeObject(e.first), Util::makeObject(e.second));
+			}
+			return res;
+		}
+
+		/// \brief converts an std vector of ints into an IntArrayObject (contiguous storage without one object per element)
+		static ScriptObjectPtr makeObject(const std::vector<int>& vec);
+
+		/// \brief converts an std vector of floats into a FloatArrayObject (contiguous storage without one object per element)
+		static ScriptObjectPtr makeObject(const std::vector<float>& vec);
+
 		/// \brief returns the script object if the pointer is valid. NullObject will be returned otherwise
 		template<class T>
 		static std::enable_if_t<std::is_base_of_v<ScriptObject, T>, 
@@ -309,7 +353,8 @@ namespace script
 
 						try
 						{
-							for (auto o : *array_object)
+							const ArrayObject& items = *array_object;
+							for (const auto& o : items)
 							{
 								res.emplace_back(fromObject<item_type>(o));
 							}
@@ -325,6 +370,35 @@ namespace script
 					}
 				}
 
+				// target object is std::unordered_map and source object is MapObject
+				if constexpr(is_std_unordered_map_v<bare_type>)
+				{
+					const auto map_object = std::dynamic_pointer_cast<MapObject>(obj);
+					if (map_object)
+					{
+						using key_type = typename bare_type::key_type;
+						using mapped_type = typename bare_type::mapped_type;
+						bare_type res;
+						res.reserve(map_object->getCount());
+
+						try
+						{
+							map_object->forEach([&res](const ScriptObjectPtr& key, const ScriptObjectPtr& value)
+							{
+								res.emplace(fromObject<key_type>(key), fromObject<mapped_type>(value));
+							});
+						}
+						catch (const InvalidArgumentConversion&)
+						{
+							std::stringstream ss;
+							ss << "std::unordered_map<" << prettyTypeName(typeid(key_type).name()) << ", " << prettyTypeName(typeid(mapped_type).name()) << ">";
+							throw InvalidArgumentConversion(ss.str());
+						}
+
+						return res;
+					}
+				}
+
 				// embedded into value object?
 				// cast to value object
 				auto* valuePtr = dynamic_cast<GetValueObject<bare_type>*>(obj.get()); // T& => T
@@ -368,6 +442,62 @@ namespace script
 			}
 			return object->toString();
 		}
+
+#pragma region Number Conversion
+
+		/// \brief buffer size that is sufficient for writeNumber
+		static constexpr size_t MaxNumberLength = 32;
+
+		/// \brief writes the decimal representation of value into buffer (std::to_chars) and returns the end
+		template<class T>
+		static std::enable_if_t<std::is_integral_v<T>, char*> writeNumber(char* buffer, T value)
+		{
+			return std::to_chars(buffer, buffer + MaxNumberLength, value).ptr;
+		}
+
+		/// \brief writes the shortest representation of value that round-trips into buffer and returns the end.
+		/// ".0" will be appended to finite values without decimal point or exponent (2.0f => "2.0")
+		static char* writeNumber(char* buffer, float value)
+		{
+			char* end = std::to_chars(buffer, buffer + MaxNumberLength, value).ptr;
+			if (std::isfinite(value) && std::find_if(buffer, end, [](char c) { return c == '.' || c == 'e'; }) == end)
+			{
+				*end++ = '.';
+				*end++ = '0';
+			}
+			return end;
+		}
+
+		/// \brief returns the representation of writeNumber as string
+		template<class T>
+		static std::string numberToString(T value)
+		{
+			char buffer[MaxNumberLength];
+			return std::string(buffer, writeNumber(buffer, value));
+		}
+
+		/// \brief parses the number at the start of text (std::from_chars). Leading whitespaces and a plus sign are skipped
+		/// like std::stoi/std::stof. Throws std::invalid_argument or std::out_of_range like std::stoi
+		template<class T>
+		static T parseNumber(std::string_view text)
+		{
+			size_t start = 0;
+			while (start < text.size() && std::isspace(static_cast<unsigned char>(text[start])))
+				++start;
+			if (start + 1 < text.size() && text[start] == '+' && text[start + 1] != '-')
+				++start;
+
+			T value{};
+			const auto res = std::from_chars(text.data() + start, text.data() + text.size(), value);
+			if (res.ec == std::errc::invalid_argument)
+				throw std::invalid_argument("cannot convert \"" + std::string(text) + "\" to a number");
+			if (res.ec == std::errc::result_out_of_range)
+				throw std::out_of_range("\"" + std::string(text) + "\" is out of range");
+			return value;
+		}
+
+#pragma endregion
+
 	private:
 #pragma region fromLambda
 
@@ -405,6 +535,10 @@ namespace script
 		// std::vector helper
 		template<class T> static inline constexpr bool is_std_vector_v = false;
 		template<class T, class A> static inline constexpr bool is_std_vector_v<std::vector<T, A>> = true;
+
+		// std::unordered_map helper
+		template<class T> static inline constexpr bool is_std_unordered_map_v = false;
+		template<class K, class V, class H, class E, class A> static inline constexpr bool is_std_unordered_map_v<std::unordered_map<K, V, H, E, A>> = true;
 #pragma region invokeArgs
 
 		/// \brief helper function to call unpack arg with the appropriate indices from the index sequence
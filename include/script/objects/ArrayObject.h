@@ -1,10 +1,11 @@
 #pragma once
 #include <vector>
 #include "ScriptObject.h"
-#include "../BoolMutex.h"
 
 namespace script
 {
+	class ThreadPool;
+
 	class ArrayObject final : public ScriptObject
 	{
 	public:
@@ -13,9 +14,12 @@ namespace script
 		~ArrayObject() override = default;
 
 		std::string toString() const override final;
+		void writeTo(OutputSink& sink) const override final;
 		ScriptObjectPtr clone() const override final;
 		/// \brief memberwise comparision with another array
 		bool equals(const ScriptObjectPtr& other) const override;
+		/// \brief combined hash of the elements
+		size_t hashCode() const override;
 
 		const ScriptObjectPtr& get(int index) const;
 		void set(int index, ScriptObjectPtr object);
@@ -24,19 +28,73 @@ namespace script
 		void clear();
 		void addAll(const ScriptPtr<ArrayObject>& other);
 		int getCount() const;
-		/// \brief returns the array subset [from, from + getCount) as shallow copy
+		/// \brief returns the array subset [from, from + getCount) as shallow copy.
+		/// The storage will be shared with this array until one of them is modified
 		ScriptPtr<ArrayObject> slice(int from, int count);
 		/// \brief returns the array subset [from, end) as shallow copy
 		ScriptPtr<ArrayObject> slice(int from);
 
+		/// \brief sorts the elements in ascending order of compare() (stable)
+		void sort();
+		/// \brief sorts the elements by the value of their property (element.property) (stable)
+		void sortBy(const std::string& property);
+		/// \brief returns the index of the first element that equals object or -1
+		int indexOf(const ScriptObjectPtr& object) const;
+		bool contains(const ScriptObjectPtr& object) const;
+		/// \brief searches the sorted array with compare(). Returns the index of object or (-insertionPoint - 1)
+		int binarySearch(const ScriptObjectPtr& object) const;
+
+		/// \brief calls element.name(args...) for every element. The same argument array is passed to all calls
+		void invokeAll(const std::string& name, const ScriptPtr<ArrayObject>& args) const;
+		/// \brief returns an array with the results of element.name(args...)
+		ScriptPtr<ArrayObject> mapInvoke(const std::string& name, const ScriptPtr<ArrayObject>& args) const;
+
+		/// \brief invokeAll on the threads of the pool (default: ThreadPool::getCurrent()).
+		/// Runs on the calling thread if the function is not pure (Util::makePure) for all element types,
+		/// if an object is contained more than once, if an element is passed as argument (directly or inside an array)
+		/// or if no pool is available
+		void parallelInvokeAll(const std::string& name, const ScriptPtr<ArrayObject>& args, ThreadPool* pool = nullptr) const;
+		/// \brief mapInvoke on the threads of the pool (see parallelInvokeAll)
+		ScriptPtr<ArrayObject> parallelMap(const std::string& name, const ScriptPtr<ArrayObject>& args, ThreadPool* pool = nullptr) const;
+		/// \brief combines the elements with result.name(element). The function must be associative.
+		/// Each thread reduces a range into a clone of its first element. The results of the ranges are combined in order
+		ScriptObjectPtr parallelReduce(const std::string& name, ThreadPool* pool = nullptr) const;
+		/// \brief number of elements that are processed by one task of the parallel functions
+		static constexpr size_t ParallelGrainSize = 1024;
+
+		/// \brief order that is used by sort: numbers and strings are compared by value, other objects must
+		/// implement the script function "int compareTo(object)". Returns a negative value if left is less than right,
+		/// zero if they are equal and a positive value otherwise
+		static int compare(const ScriptObjectPtr& left, const ScriptObjectPtr& right);
+		/// \brief arrays of ints, floats or strings with at least this many elements are sorted on the threads of
+		/// ThreadPool::getCurrent() (sequentially if no pool is available)
+		static constexpr size_t ParallelSortThreshold = 1 << 16;
+
 		// c++ helper functions
 		std::vector<ScriptObjectPtr>::iterator begin();
 		std::vector<ScriptObjectPtr>::iterator end();
 		std::vector<ScriptObjectPtr>::const_iterator begin() const;
 		std::vector<ScriptObjectPtr>::const_iterator end() const;
 	private:
-		std::vector<ScriptObjectPtr> m_values;
-		mutable BoolMutex m_toStringMutex;
+		/// \brief makes sure that the storage is not shared with another array before it will be modified
+		void detach();
+		/// \brief reorders the elements by the keys (keys[i] belongs to the i-th element)
+		void sortByKeys(const std::vector<ScriptObjectPtr>& keys);
+		/// \brief calls func(element, function) for every element after verifying that every element type has the function
+		template<class TFunc>
+		void forEachFunction(const std::string& name, const char* caller, TFunc func) const;
+		/// \brief verifies the function of every element type and returns the pool if the function may run in parallel
+		/// \param args arguments of the function if the elements are modified (nullptr otherwise).
+		/// The elements must be distinct and must not be reachable from the arguments
+		ThreadPool* getParallelPool(const std::string& name, const char* caller, const ArrayObject* args, ThreadPool* pool) const;
+		/// \brief reduces [begin, end) into a clone of the first element
+		ScriptObjectPtr reduceRange(const std::string& name, size_t begin, size_t end) const;
+
+		// element storage. slices and copies share the storage until one of them is modified (copy on write)
+		std::shared_ptr<std::vector<ScriptObjectPtr>> m_values;
+		// visible range [m_offset, m_offset + m_count) of m_values
+		size_t m_offset = 0;
+		size_t m_count = 0;
 	};
 
 	using ArrayObjectPtr = ScriptPtr<ArrayObject>;
@@ -0,0 +1,298 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include "ScriptObject.h"
+#include "../Util.h"
+#include "../NumericKernels.h"
+#include "../OutputSink.h"
+#include "../Hash.h"
+
+namespace script
+{
+	/// \brief array of T values that references host memory without copying it.
+	/// The memory is either pinned (the view holds a reference to the owner) or borrowed (the host must call release()
+	/// before the memory is freed). The host must not reallocate the memory while a view is valid.
+	/// Releasing a view releases all of its slices (and their slices) but not the view it was sliced from
+	template<class T>
+	class ArrayViewObject final : public ScriptObject
+	{
+	public:
+		/// \param data first element
+		/// \param count number of elements
+		/// \param writable indicates if set() is allowed
+		/// \param owner (optional) keeps the memory alive as long as the view exists
+		ArrayViewObject(T* data, size_t count, bool writable, std::shared_ptr<const void> owner)
+			:
+		ArrayViewObject(data, count, writable, std::move(owner), std::make_shared<ReleaseState>(nullptr))
+		{}
+		~ArrayViewObject() override = default;
+
+		/// \brief creates a view that keeps the vector alive
+		static ScriptPtr<ArrayViewObject<T>> pin(std::shared_ptr<std::vector<T>> vector, bool writable = false)
+		{
+			T* data = vector->data();
+			const size_t count = vector->size();
+			return std::make_shared<ArrayViewObject<T>>(data, count, writable, std::move(vector));
+		}
+
+		/// \brief creates a read only view that keeps the vector alive
+		static ScriptPtr<ArrayViewObject<T>> pin(std::shared_ptr<const std::vector<T>> vector)
+		{
+			T* data = const_cast<T*>(vector->data());
+			const size_t count = vector->size();
+			return std::make_shared<ArrayViewObject<T>>(data, count, false, std::move(vector));
+		}
+
+		/// \brief creates a view of memory that is owned by the host. release() must be called before the memory is freed
+		static ScriptPtr<ArrayViewObject<T>> borrow(T* data, size_t count, bool writable = false)
+		{
+			return std::make_shared<ArrayViewObject<T>>(data, count, writable, nullptr);
+		}
+
+		/// \brief creates a read only view of memory that is owned by the host. release() must be called before the memory is freed
+		static ScriptPtr<ArrayViewObject<T>> borrow(const T* data, size_t count)
+		{
+			return std::make_shared<ArrayViewObject<T>>(const_cast<T*>(data), count, false, nullptr);
+		}
+
+		std::string toString() const override
+		{
+			StringSink sink;
+			writeTo(sink);
+			return sink.release();
+		}
+
+		void writeTo(OutputSink& sink) const override
+		{
+			if (!isValid())
+			{
+				sink.write("released view");
+				return;
+			}
+
+			sink.write('[');
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				if (i != 0)
+					sink.write(", ");
+				char buffer[Util::MaxNumberLength];
+				if (!sink.write(std::string_view(buffer, Util::writeNumber(buffer, m_data[i]) - buffer)))
+				{
+					sink.setTruncated();
+					return;
+				}
+			}
+			sink.write(']');
+		}
+
+		/// \brief returns a copy of the values (IntArrayObject or FloatArrayObject)
+		ScriptObjectPtr clone() const override
+		{
+			return copy();
+		}
+
+		/// \brief compares the values of two views. A view is never equal to a NumericArrayObject<T>
+		/// because NumericArrayObject<T>::equals only accepts its own type (equals must be symmetric)
+		bool equals(const ScriptObjectPtr& other) const override
+		{
+			if (!isValid()) return ScriptObject::equals(other);
+
+			auto view = dynamic_cast<const ArrayViewObject<T>*>(other.get());
+			if (view == nullptr || !view->isValid()) return false;
+			return std::equal(m_data, m_data + m_count, view->m_data, view->m_data + view->m_count);
+		}
+
+		/// \brief hash of the values
+		size_t hashCode() const override
+		{
+			if (!isValid()) return ScriptObject::hashCode();
+			return hash::range(m_data, m_data + m_count);
+		}
+
+		T get(int index) const
+		{
+			verifyIndex(index, "get");
+			return m_data[index];
+		}
+
+		void set(int index, T value)
+		{
+			verifyIndex(index, "set");
+			if (!m_writable)
+				throw std::runtime_error("ArrayViewObject::set view is read only");
+			m_data[index] = value;
+		}
+
+		int getCount() const
+		{
+			return isValid() ? static_cast<int>(m_count) : 0;
+		}
+
+		bool isWritable() const
+		{
+			return m_writable;
+		}
+
+		/// \brief returns false if the view (or one of the views it was sliced from) was released
+		bool isValid() const
+		{
+			return !m_state->isReleased();
+		}
+
+		/// \brief detaches the view and all of its slices from the memory. All further accesses will throw.
+		/// The view it was sliced from stays valid
+		void release()
+		{
+			m_state->released.store(true, std::memory_order_release);
+			m_data = nullptr;
+			m_count = 0;
+			m_owner.reset();
+		}
+
+		/// \brief returns a view of the subset [from, from + count) without copying.
+		/// The slice is released together with this view
+		ScriptPtr<ArrayViewObject<T>> slice(int from, int count) const
+		{
+			verifyValid("slice");
+			if (from < 0 || size_t(from) > m_count)
+				throw std::out_of_range("ArrayViewObject::slice from out of range");
+			if (count < 0)
+				throw std::runtime_error("ArrayViewObject::slice count may not be smaller than zero");
+			if (size_t(from) + size_t(count) > m_count)
+				throw std::out_of_range("ArrayViewObject::slice count exceeds array");
+
+			return ScriptPtr<ArrayViewObject<T>>(new ArrayViewObject<T>(m_data + from, size_t(count), m_writable, m_owner, std::make_shared<ReleaseState>(m_state)));
+		}
+
+		/// \brief copies the values into an IntArrayObject or FloatArrayObject
+		ScriptObjectPtr copy() const
+		{
+			verifyValid("copy");
+			return Util::makeObject(std::vector<T>(m_data, m_data + m_count));
+		}
+
+		/// \brief converts the values into an ArrayObject with one ScriptObject per element
+		ArrayObjectPtr toArray() const
+		{
+			verifyValid("toArray");
+			std::vector<ScriptObjectPtr> res;
+			res.reserve(m_count);
+			for (size_t i = 0; i < m_count; ++i)
+				res.push_back(Util::makeObject(m_data[i]));
+
+			return std::make_shared<ArrayObject>(move(res));
+		}
+
+		T getSum() const
+		{
+			verifyValid("getSum");
+			return static_cast<T>(kernels::sum(m_data, m_count));
+		}
+
+		T getMin() const
+		{
+			verifyNotEmpty("getMin");
+			return kernels::minimum(m_data, m_count);
+		}
+
+		T getMax() const
+		{
+			verifyNotEmpty("getMax");
+			return kernels::maximum(m_data, m_count);
+		}
+
+		float getMean() const
+		{
+			verifyNotEmpty("getMean");
+			return static_cast<float>(double(kernels::sum(m_data, m_count)) / double(m_count));
+		}
+
+		/// \brief nullptr if the view was released
+		const T* data() const
+		{
+			return isValid() ? m_data : nullptr;
+		}
+
+	private:
+		/// \brief released flag of a view. A slice is released if its own flag or the flag of a parent is set
+		struct ReleaseState
+		{
+			explicit ReleaseState(std::shared_ptr<const ReleaseState> parent)
+				:
+			parent(std::move(parent))
+			{}
+
+			bool isReleased() const
+			{
+				for (auto s = this; s != nullptr; s = s->parent.get())
+					if (s->released.load(std::memory_order_acquire))
+						return true;
+				return false;
+			}
+
+			// atomic: slices may be used by other threads (parallel functions)
+			std::atomic<bool> released{ false };
+			std::shared_ptr<const ReleaseState> parent;
+		};
+
+		ArrayViewObject(T* data, size_t count, bool writable, std::shared_ptr<const void> owner, std::shared_ptr<ReleaseState> state)
+			:
+		m_data(data),
+		m_count(count),
+		m_writable(writable),
+		m_owner(std::move(owner)),
+		m_state(std::move(state))
+		{
+			setFunctions();
+		}
+
+		void verifyValid(const char* function) const
+		{
+			if (!isValid())
+				throw std::runtime_error(std::string("ArrayViewObject::") + function + " view was released");
+		}
+
+		void verifyNotEmpty(const char* function) const
+		{
+			verifyValid(function);
+			if (m_count == 0)
+				throw std::runtime_error(std::string("ArrayViewObject::") + function + " view is empty");
+		}
+
+		void verifyIndex(int index, const char* function) const
+		{
+			verifyValid(function);
+			if (index < 0 || size_t(index) >= m_count)
+				throw std::out_of_range(std::string("ArrayViewObject::") + function + " index out of range: " + std::to_string(index));
+		}
+
+		void setFunctions()
+		{
+			using Self = ArrayViewObject<T>;
+			addFunction("get", Util::makeFunction(this, &Self::get, "T ArrayViewObject<T>::get(int index)"));
+			addFunction("set", Util::makeFunction(this, &Self::set, "ArrayViewObject<T>::set(int index, T value)"));
+			addFunction("getCount", Util::makeFunction(this, &Self::getCount, "int ArrayViewObject<T>::getCount()"));
+			addFunction("isWritable", Util::makeFunction(this, &Self::isWritable, "bool ArrayViewObject<T>::isWritable()"));
+			addFunction("isValid", Util::makeFunction(this, &Self::isValid, "bool ArrayViewObject<T>::isValid()"));
+			addFunction("slice", Util::makeFunction(this, &Self::slice, "ArrayViewObject<T> ArrayViewObject<T>::slice(int from, int count)"));
+			addFunction("copy", Util::makeFunction(this, &Self::copy, "NumericArrayObject<T> ArrayViewObject<T>::copy()"));
+			addFunction("toArray", Util::makeFunction(this, &Self::toArray, "ArrayObject ArrayViewObject<T>::toArray()"));
+			addFunction("getSum", Util::makeFunction(this, &Self::getSum, "T ArrayViewObject<T>::getSum()"));
+			addFunction("getMin", Util::makeFunction(this, &Self::getMin, "T ArrayViewObject<T>::getMin()"));
+			addFunction("getMax", Util::makeFunction(this, &Self::getMax, "T ArrayViewObject<T>::getMax()"));
+			addFunction("getMean", Util::makeFunction(this, &Self::getMean, "float ArrayViewObject<T>::getMean()"));
+		}
+
+		T* m_data;
+		size_t m_count;
+		bool m_writable;
+		std::shared_ptr<const void> m_owner;
+		// own state of this view (the slices reference it as parent)
+		std::shared_ptr<ReleaseState> m_state;
+	};
+
+	using IntArrayViewObject = ArrayViewObject<int>;
+	using FloatArrayViewObject = ArrayViewObject<float>;
+}
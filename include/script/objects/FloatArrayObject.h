@@ -0,0 +1,18 @@
+#pragma once
+#include "NumericArrayObject.h"
+
+namespace script
+{
+	class FloatArrayObject final : public NumericArrayObject<float>
+	{
+	public:
+		FloatArrayObject();
+		explicit FloatArrayObject(std::vector<float> values);
+		~FloatArrayObject() override final = default;
+
+		static FunctionT getCtor();
+
+	protected:
+		ScriptPtr<NumericArrayObject<float>> make(std::vector<float> values) const override;
+	};
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "NumericArrayObject.h"
+
+namespace script
+{
+	class IntArrayObject final : public NumericArrayObject<int>
+	{
+	public:
+		IntArrayObject();
+		explicit IntArrayObject(std::vector<int> values);
+		~IntArrayObject() override final = default;
+
+		static FunctionT getCtor();
+
+	protected:
+		ScriptPtr<NumericArrayObject<int>> make(std::vector<int> values) const override;
+	};
+}
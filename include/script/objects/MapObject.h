@@ -0,0 +1,81 @@
+#pragma once
+#include <vector>
+#include "ScriptObject.h"
+#include "ArrayObject.h"
+
+namespace script
+{
+	/// \brief hash map from script objects to script objects (open addressing with linear probing).
+	/// Keys are compared with equals() and will be cloned on insertion
+	class MapObject final : public ScriptObject
+	{
+	public:
+		MapObject();
+		~MapObject() override = default;
+
+		static FunctionT getCtor();
+
+		std::string toString() const override final;
+		void writeTo(OutputSink& sink) const override final;
+		/// \brief clones all values
+		ScriptObjectPtr clone() const override final;
+		/// \brief compares the key value pairs with another map
+		bool equals(const ScriptObjectPtr& other) const override final;
+		/// \brief order independent hash of the key value pairs
+		size_t hashCode() const override final;
+
+		/// \brief returns the value of key. Throws std::out_of_range if the key does not exist
+		const ScriptObjectPtr& get(const ScriptObjectPtr& key) const;
+		/// \brief returns the value of key or defaultValue if the key does not exist
+		ScriptObjectPtr get(const ScriptObjectPtr& key, const ScriptObjectPtr& defaultValue) const;
+		/// \brief returns the value of key or nullptr if the key does not exist
+		ScriptObjectPtr find(const ScriptObjectPtr& key) const;
+		/// \brief inserts or replaces the value of key
+		void set(const ScriptObjectPtr& key, ScriptObjectPtr value);
+		bool has(const ScriptObjectPtr& key) const;
+		/// \brief returns true if the key was removed
+		bool remove(const ScriptObjectPtr& key);
+		void clear();
+		int getCount() const;
+		/// \brief returns copies of all keys
+		ArrayObjectPtr getKeys() const;
+		ArrayObjectPtr getValues() const;
+
+		/// \brief makes sure that count elements can be stored without rehashing
+		void reserve(int count);
+		/// \brief sets the number of slots (rounded up to a power of two and the required size for the current elements)
+		void rehash(int capacity);
+		/// \brief number of slots
+		int getCapacity() const;
+		/// \brief the table grows if the count exceeds capacity * maxLoadFactor. Must be in (0, 1)
+		void setMaxLoadFactor(float factor);
+		float getMaxLoadFactor() const;
+
+		/// \brief calls func(key, value) for every entry
+		template<class TFunc>
+		void forEach(TFunc func) const
+		{
+			for (const auto& slot : m_slots)
+				if (slot.key) func(slot.key, slot.value);
+		}
+	private:
+		struct Slot
+		{
+			ScriptObjectPtr key;
+			ScriptObjectPtr value;
+			size_t hash = 0;
+		};
+
+		/// \brief returns the slot index of the key or size_t(-1)
+		size_t findSlot(const ScriptObjectPtr& key, size_t hash) const;
+		/// \brief ideal slot index of the hash
+		size_t getBucket(size_t hash) const;
+		void resize(size_t capacity);
+
+		std::vector<Slot> m_slots;
+		size_t m_count = 0;
+		float m_maxLoadFactor = 0.75f;
+	};
+
+	using MapObjectPtr = ScriptPtr<MapObject>;
+}
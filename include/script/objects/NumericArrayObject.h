@@ -0,0 +1,378 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "ValueComparableObject.h"
+#include "../Util.h"
+#include "../NumericKernels.h"
+#include "../OutputSink.h"
+
+namespace script
+{
+	/// \brief array of T values that are stored in contiguous memory (instead of one ScriptObject per element).
+	/// Provides the same basic interface as the ArrayObject.
+	template<class T>
+	class NumericArrayObject : public ValueComparableObject<std::vector<T>>
+	{
+	public:
+		~NumericArrayObject() override = default;
+
+		std::string toString() const override
+		{
+			StringSink sink;
+			writeTo(sink);
+			return sink.release();
+		}
+
+		void writeTo(OutputSink& sink) const override
+		{
+			sink.write('[');
+			for (size_t i = 0; i < this->m_value.size(); ++i)
+			{
+				if (i != 0)
+					sink.write(", ");
+				char buffer[Util::MaxNumberLength];
+				if (!sink.write(std::string_view(buffer, Util::writeNumber(buffer, this->m_value[i]) - buffer)))
+				{
+					sink.setTruncated();
+					return;
+				}
+			}
+			sink.write(']');
+		}
+
+		ScriptObjectPtr clone() const override
+		{
+			return make(this->m_value);
+		}
+
+		T get(int index) const
+		{
+			if (index >= getCount() || index < 0)
+				throw std::out_of_range("NumericArrayObject::get index out of range: " + std::to_string(index));
+
+			return this->m_value[index];
+		}
+
+		void set(int index, T value)
+		{
+			if (index >= getCount() || index < 0)
+				throw std::out_of_range("NumericArrayObject::set index out of range: " + std::to_string(index));
+
+			this->m_value[index] = value;
+		}
+
+		void add(T value)
+		{
+			this->m_value.push_back(value);
+		}
+
+		void addAll(std::vector<T> values)
+		{
+			this->m_value.insert(this->m_value.end(), values.begin(), values.end());
+		}
+
+		void remove(int index)
+		{
+			if (index >= getCount() || index < 0)
+				throw std::out_of_range("NumericArrayObject::remove index out of range: " + std::to_string(index));
+
+			this->m_value.erase(this->m_value.begin() + index);
+		}
+
+		void clear()
+		{
+			this->m_value.clear();
+		}
+
+		int getCount() const
+		{
+			return static_cast<int>(this->m_value.size());
+		}
+
+		/// \brief returns the array subset [from, from + count) as copy
+		ScriptPtr<NumericArrayObject<T>> slice(int from, int count) const
+		{
+			if (from >= getCount() || from < 0)
+				throw std::out_of_range("NumericArrayObject::slice from out of range");
+			if (count < 0)
+				throw std::runtime_error("NumericArrayObject::slice count may not be smaller than zero");
+			if (from + count > getCount())
+				throw std::out_of_range("NumericArrayObject::slice count exceeds array");
+
+			return make(std::vector<T>(this->m_value.begin() + from, this->m_value.begin() + from + count));
+		}
+
+		/// \brief returns the array subset [from, end) as copy
+		ScriptPtr<NumericArrayObject<T>> slice(int from) const
+		{
+			return slice(from, getCount() - from);
+		}
+
+		/// \brief converts the values into an ArrayObject with one ScriptObject per element
+		ArrayObjectPtr toArray() const
+		{
+			std::vector<ScriptObjectPtr> res;
+			res.reserve(this->m_value.size());
+			for (const auto& v : this->m_value)
+				res.push_back(Util::makeObject(v));
+
+			return std::make_shared<ArrayObject>(move(res));
+		}
+
+#pragma region Element-wise Operations
+
+		// the element-wise operations use vectorized kernels (see NumericKernels.h)
+
+		void addEach(T value)
+		{
+			kernels::add(this->m_value.data(), value, this->m_value.size());
+		}
+
+		void addEach(const NumericArrayObject<T>& other)
+		{
+			kernels::add(this->m_value.data(), other.data("addEach", *this), this->m_value.size());
+		}
+
+		void subtractEach(T value)
+		{
+			kernels::subtract(this->m_value.data(), value, this->m_value.size());
+		}
+
+		void subtractEach(const NumericArrayObject<T>& other)
+		{
+			kernels::subtract(this->m_value.data(), other.data("subtractEach", *this), this->m_value.size());
+		}
+
+		void multiplyEach(T value)
+		{
+			kernels::multiply(this->m_value.data(), value, this->m_value.size());
+		}
+
+		void multiplyEach(const NumericArrayObject<T>& other)
+		{
+			kernels::multiply(this->m_value.data(), other.data("multiplyEach", *this), this->m_value.size());
+		}
+
+		void divideEach(T value)
+		{
+			if constexpr (std::is_integral_v<T>)
+			{
+				if (value == T(0) && !this->m_value.empty())
+					throw std::runtime_error("NumericArrayObject::divideEach division by zero");
+				if (value == T(-1) && std::find(this->m_value.begin(), this->m_value.end(), std::numeric_limits<T>::min()) != this->m_value.end())
+					throw std::runtime_error("NumericArrayObject::divideEach integer overflow");
+			}
+			kernels::divide(this->m_value.data(), value, this->m_value.size());
+		}
+
+		void divideEach(const NumericArrayObject<T>& other)
+		{
+			const T* src = other.data("divideEach", *this);
+			if constexpr (std::is_integral_v<T>)
+			{
+				if (std::find(other.m_value.begin(), other.m_value.end(), T(0)) != other.m_value.end())
+					throw std::runtime_error("NumericArrayObject::divideEach division by zero");
+				for (size_t i = 0; i < this->m_value.size(); ++i)
+					if (src[i] == T(-1) && this->m_value[i] == std::numeric_limits<T>::min())
+						throw std::runtime_error("NumericArrayObject::divideEach integer overflow");
+			}
+			kernels::divide(this->m_value.data(), src, this->m_value.size());
+		}
+
+		void negateEach()
+		{
+			kernels::negate(this->m_value.data(), this->m_value.size());
+		}
+
+		void absEach()
+		{
+			kernels::abs(this->m_value.data(), this->m_value.size());
+		}
+
+		/// \brief clamps every element into [low, high]
+		void clampEach(T low, T high)
+		{
+			if (high < low)
+				throw std::runtime_error("NumericArrayObject::clampEach low must not be greater than high");
+			kernels::clamp(this->m_value.data(), low, high, this->m_value.size());
+		}
+
+		/// \brief value = value * mul + add for every element
+		void multiplyAddEach(T mul, T add)
+		{
+			kernels::multiplyAdd(this->m_value.data(), mul, add, this->m_value.size());
+		}
+
+		/// \brief value[i] = value[i] * mul[i] + add[i] for every element
+		void multiplyAddEach(const NumericArrayObject<T>& mul, const NumericArrayObject<T>& add)
+		{
+			const T* mulData = mul.data("multiplyAddEach", *this);
+			const T* addData = add.data("multiplyAddEach", *this);
+			kernels::multiplyAdd(this->m_value.data(), mulData, addData, this->m_value.size());
+		}
+
+#pragma endregion
+
+#pragma region Reductions
+
+		/// \brief sum of all elements. Integers will overflow like the IntObject
+		T getSum() const
+		{
+			return static_cast<T>(kernels::sum(this->m_value.data(), this->m_value.size()));
+		}
+
+		T getMin() const
+		{
+			verifyNotEmpty("getMin");
+			return kernels::minimum(this->m_value.data(), this->m_value.size());
+		}
+
+		T getMax() const
+		{
+			verifyNotEmpty("getMax");
+			return kernels::maximum(this->m_value.data(), this->m_value.size());
+		}
+
+		float getMean() const
+		{
+			verifyNotEmpty("getMean");
+			// integer sum is 64 bit
+			return static_cast<float>(double(kernels::sum(this->m_value.data(), this->m_value.size())) / double(this->m_value.size()));
+		}
+
+		/// \brief population variance
+		float getVariance() const
+		{
+			const float mean = getMean();
+			return kernels::sumSquaredDeviation(this->m_value.data(), mean, this->m_value.size()) / float(this->m_value.size());
+		}
+
+		/// \brief returns the p-th percentile (p in [0, 100]) with linear interpolation between the closest ranks
+		float getPercentile(float p) const
+		{
+			verifyNotEmpty("getPercentile");
+			if (!(p >= 0.0f && p <= 100.0f))
+				throw std::out_of_range("NumericArrayObject::getPercentile p must be in [0, 100]: " + std::to_string(p));
+
+			std::vector<T> values = this->m_value;
+			const double rank = double(p) / 100.0 * double(values.size() - 1);
+			const size_t lower = static_cast<size_t>(rank);
+			// NaN is greater than all numbers (same order as ArrayObject::sort)
+			const auto less = [](T a, T b)
+			{
+				if constexpr (std::is_floating_point_v<T>)
+				{
+					if (std::isnan(a)) return false;
+					return std::isnan(b) || a < b;
+				}
+				else return a < b;
+			};
+			std::nth_element(values.begin(), values.begin() + lower, values.end(), less);
+			const double lowerValue = double(values[lower]);
+			if (lower + 1 >= values.size())
+				return static_cast<float>(lowerValue);
+
+			// all elements after lower are greater or equal => the next rank is the smallest of them
+			const double upperValue = double(*std::min_element(values.begin() + lower + 1, values.end(), less));
+			return static_cast<float>(lowerValue + (upperValue - lowerValue) * (rank - double(lower)));
+		}
+
+#pragma endregion
+
+	protected:
+		explicit NumericArrayObject(std::vector<T> values)
+			:
+		ValueComparableObject<std::vector<T>>(std::move(values))
+		{
+			setFunctions();
+		}
+
+		/// \brief creates a new array of the derived type
+		virtual ScriptPtr<NumericArrayObject<T>> make(std::vector<T> values) const = 0;
+
+	private:
+		/// \brief returns the data pointer if both arrays have the same size
+		const T* data(const char* function, const NumericArrayObject<T>& dst) const
+		{
+			if (this->m_value.size() != dst.m_value.size())
+				throw std::runtime_error(std::string("NumericArrayObject::") + function + " array sizes do not match: "
+					+ std::to_string(dst.m_value.size()) + " and " + std::to_string(this->m_value.size()));
+			return this->m_value.data();
+		}
+
+		void verifyNotEmpty(const char* function) const
+		{
+			if (this->m_value.empty())
+				throw std::runtime_error(std::string("NumericArrayObject::") + function + " array is empty");
+		}
+
+		void setFunctions()
+		{
+			this->addFunction("get", Util::makeFunction(this, &NumericArrayObject<T>::get, "T NumericArrayObject<T>::get(int index)"));
+			this->addFunction("set", Util::makeFunction(this, &NumericArrayObject<T>::set, "NumericArrayObject<T>::set(int index, T value)"));
+			this->addFunction("add", [this](const ArrayObjectPtr& args)
+			{
+				// add all elements
+				std::vector<T> values;
+				values.reserve(args->getCount());
+				for (int i = 0; i < args->getCount(); ++i)
+				{
+					try
+					{
+						values.push_back(Util::fromObject<T>(args->get(i)));
+					}
+					catch (const InvalidArgumentConversion& e)
+					{
+						throw InvalidArgumentType("NumericArrayObject<T>::add(T...)", i, *args->get(i), e.desiredType);
+					}
+				}
+				this->addAll(move(values));
+				return this->shared_from_this();
+			});
+			this->addFunction("addAll", Util::makeFunction(this, &NumericArrayObject<T>::addAll, "NumericArrayObject<T>::addAll(T[] values)"));
+			this->addFunction("remove", Util::makeFunction(this, &NumericArrayObject<T>::remove, "NumericArrayObject<T>::remove(int index)"));
+			this->addFunction("clear", Util::makeFunction(this, &NumericArrayObject<T>::clear, "NumericArrayObject<T>::clear()"));
+			this->addFunction("getCount", Util::makeFunction(this, &NumericArrayObject<T>::getCount, "int NumericArrayObject<T>::getCount()"));
+			this->addFunction("slice", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<ScriptPtr<NumericArrayObject<T>>(NumericArrayObject<T>::*)(int, int) const>(&NumericArrayObject<T>::slice), "NumericArrayObject<T> NumericArrayObject<T>::slice(int from, int count)"),
+				Util::makeFunction(this, static_cast<ScriptPtr<NumericArrayObject<T>>(NumericArrayObject<T>::*)(int) const>(&NumericArrayObject<T>::slice), "NumericArrayObject<T> NumericArrayObject<T>::slice(int from)")
+			}));
+			this->addFunction("toArray", Util::makeFunction(this, &NumericArrayObject<T>::toArray, "ArrayObject NumericArrayObject<T>::toArray()"));
+
+			using Arr = const NumericArrayObject<T>&;
+			using Self = NumericArrayObject<T>;
+			this->addFunction("addEach", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<void(Self::*)(T)>(&Self::addEach), "NumericArrayObject<T>::addEach(T value)"),
+				Util::makeFunction(this, static_cast<void(Self::*)(Arr)>(&Self::addEach), "NumericArrayObject<T>::addEach(NumericArrayObject<T> other)")
+			}));
+			this->addFunction("subtractEach", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<void(Self::*)(T)>(&Self::subtractEach), "NumericArrayObject<T>::subtractEach(T value)"),
+				Util::makeFunction(this, static_cast<void(Self::*)(Arr)>(&Self::subtractEach), "NumericArrayObject<T>::subtractEach(NumericArrayObject<T> other)")
+			}));
+			this->addFunction("multiplyEach", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<void(Self::*)(T)>(&Self::multiplyEach), "NumericArrayObject<T>::multiplyEach(T value)"),
+				Util::makeFunction(this, static_cast<void(Self::*)(Arr)>(&Self::multiplyEach), "NumericArrayObject<T>::multiplyEach(NumericArrayObject<T> other)")
+			}));
+			this->addFunction("divideEach", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<void(Self::*)(T)>(&Self::divideEach), "NumericArrayObject<T>::divideEach(T value)"),
+				Util::makeFunction(this, static_cast<void(Self::*)(Arr)>(&Self::divideEach), "NumericArrayObject<T>::divideEach(NumericArrayObject<T> other)")
+			}));
+			this->addFunction("negateEach", Util::makeFunction(this, &Self::negateEach, "NumericArrayObject<T>::negateEach()"));
+			this->addFunction("absEach", Util::makeFunction(this, &Self::absEach, "NumericArrayObject<T>::absEach()"));
+			this->addFunction("clampEach", Util::makeFunction(this, &Self::clampEach, "NumericArrayObject<T>::clampEach(T low, T high)"));
+			this->addFunction("multiplyAddEach", Util::combineFunctions({
+				Util::makeFunction(this, static_cast<void(Self::*)(T, T)>(&Self::multiplyAddEach), "NumericArrayObject<T>::multiplyAddEach(T mul, T add)"),
+				Util::makeFunction(this, static_cast<void(Self::*)(Arr, Arr)>(&Self::multiplyAddEach), "NumericArrayObject<T>::multiplyAddEach(NumericArrayObject<T> mul, NumericArrayObject<T> add)")
+			}));
+
+			this->addFunction("getSum", Util::makeFunction(this, &Self::getSum, "T NumericArrayObject<T>::getSum()"));
+			this->addFunction("getMin", Util::makeFunction(this, &Self::getMin, "T NumericArrayObject<T>::getMin()"));
+			this->addFunction("getMax", Util::makeFunction(this, &Self::getMax, "T NumericArrayObject<T>::getMax()"));
+			this->addFunction("getMean", Util::makeFunction(this, &Self::getMean, "float NumericArrayObject<T>::getMean()"));
+			this->addFunction("getVariance", Util::makeFunction(this, &Self::getVariance, "float NumericArrayObject<T>::getVariance()"));
+			this->addFunction("getPercentile", Util::makeFunction(this, &Self::getPercentile, "float NumericArrayObject<T>::getPercentile(float p)"));
+		}
+	};
+}
@@ -64,12 +64,13 @@ namespace script
 	private:
 		void setFunctions()
 		{
-			this->addFunction("add", Util::makeFunction(this, &NumericalObject<T>::add, "NumericalObject<T>::add(T)"));
-			this->addFunction("subtract", Util::makeFunction(this, &NumericalObject<T>::subtract, "NumericalObject<T>::subtract(T)"));
-			this->addFunction("divide", Util::makeFunction(this, &NumericalObject<T>::divide, "NumericalObject<T>::divide(T)"));
-			this->addFunction("multiply", Util::makeFunction(this, &NumericalObject<T>::multiply, "NumericalObject<T>::multiply(T)"));
-			this->addFunction("negate", Util::makeFunction(this, &NumericalObject<T>::negate, "NumericalObject<T>::negate()"));
-			this->addFunction("set", Util::makeFunction(this, &NumericalObject<T>::set, "NumericalObject<T>::negate()"));
+			// the operations only modify this object => safe for parallel calls
+			this->addFunction("add", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::add, "NumericalObject<T>::add(T)")));
+			this->addFunction("subtract", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::subtract, "NumericalObject<T>::subtract(T)")));
+			this->addFunction("divide", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::divide, "NumericalObject<T>::divide(T)")));
+			this->addFunction("multiply", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::multiply, "NumericalObject<T>::multiply(T)")));
+			this->addFunction("negate", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::negate, "NumericalObject<T>::negate()")));
+			this->addFunction("set", Util::makePure(Util::makeFunction(this, &NumericalObject<T>::set, "NumericalObject<T>::negate()")));
 		}
 	};
 }
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include "ScriptObject.h"
+#include "ArrayObject.h"
+
+namespace script
+{
+	/// \brief lazy sequence of the integers [from, to) with the given step and a pipeline of transformations.
+	/// The pipeline functions return a new range and are evaluated element by element when the range is consumed
+	/// (sum, toArray, getCount), which keeps the memory constant.
+	class RangeObject final : public ScriptObject
+	{
+	public:
+		RangeObject(int from, int to, int step = 1);
+		~RangeObject() override = default;
+
+		/// \brief Range(to), Range(from, to) and Range(from, to, step)
+		static FunctionT getCtor();
+
+		std::string toString() const override final;
+		ScriptObjectPtr clone() const override final;
+
+		/// \brief replaces each element by the result of element.function(args...)
+		ScriptPtr<RangeObject> map(const std::string& function, ArrayObjectPtr args) const;
+		/// \brief keeps the elements where element.function(args...) returns true
+		ScriptPtr<RangeObject> filter(const std::string& function, ArrayObjectPtr args) const;
+		/// \brief keeps the first count elements
+		ScriptPtr<RangeObject> take(int count) const;
+		/// \brief drops the first count elements
+		ScriptPtr<RangeObject> skip(int count) const;
+
+		/// \brief adds all elements (element.add(next)). Returns 0 for empty ranges
+		ScriptObjectPtr sum() const;
+		ArrayObjectPtr toArray() const;
+		/// \brief number of elements after the pipeline was applied
+		int getCount() const;
+
+		/// \brief calls func(element) for every element
+		template<class TFunc>
+		void forEach(TFunc func) const
+		{
+			run([&func](int value, const ScriptObjectPtr& obj)
+			{
+				func(obj ? obj : makeInt(value));
+			});
+		}
+	private:
+		struct Stage
+		{
+			enum Type
+			{
+				Map,
+				Filter,
+				Take,
+				Skip
+			} type;
+			std::string function;
+			ArrayObjectPtr args;
+			int count;
+		};
+
+		void setFunctions();
+		ScriptPtr<RangeObject> append(Stage stage) const;
+		/// \brief runs the element through the pipeline (obj will be created by the first map or filter).
+		/// Returns false if the element was dropped. last will be set if no further element can pass the pipeline
+		bool apply(int value, ScriptObjectPtr& obj, std::vector<int>& counters, bool& last) const;
+		/// \brief true if the pipeline does not modify the integers (only take and skip)
+		bool isPlain() const;
+		static ScriptObjectPtr makeInt(int value);
+
+		/// \brief calls func(value, obj) for every element that passes the pipeline.
+		/// obj is nullptr if the element was not transformed (the element is the integer value)
+		template<class TFunc>
+		void run(TFunc func) const
+		{
+			std::vector<int> counters(m_stages.size(), 0);
+			for (long long i = m_from; m_step > 0 ? i < m_to : i > m_to; i += m_step)
+			{
+				ScriptObjectPtr obj;
+				bool last = false;
+				if (apply(int(i), obj, counters, last))
+					func(int(i), obj);
+				if (last) return;
+			}
+		}
+
+		int m_from;
+		int m_to;
+		int m_step;
+		std::vector<Stage> m_stages;
+	};
+
+	using RangeObjectPtr = ScriptPtr<RangeObject>;
+}
@@ -8,6 +8,7 @@ namespace script
 {
 	class ArrayObject;
 	class BoolObject;
+	class OutputSink;
 
 	class ScriptObject : public std::enable_shared_from_this<ScriptObject>
 	{
@@ -21,12 +22,20 @@ namespace script
 
 		virtual ~ScriptObject() = default;
 		virtual std::string toString() const;
+		/// \brief writes the string representation into the sink (default: toString()).
+		/// Implementations may stop early if the sink is full
+		virtual void writeTo(OutputSink& sink) const;
 		virtual ScriptObjectPtr clone() const;
 		virtual bool equals(const ScriptObjectPtr& other) const;
 		std::string type() const;
-		size_t hashCode() const;
+		/// \brief hash value that is consistent with equals() (default: type based)
+		virtual size_t hashCode() const;
 
 		ScriptObjectPtr invoke(const std::string& funcName, const ScriptPtr<ArrayObject>& args);
+		/// \brief returns the registered function or nullptr
+		const FunctionT* findFunction(const std::string& funcName) const;
+		/// \brief true if the function was registered with Util::makePure
+		bool isPure(const std::string& funcName) const;
 		/// \brief returns all registered functions (including getter and setter)
 		std::vector<std::string> getFunctions() const;
 		/// \brief returns all getter without the get prefix
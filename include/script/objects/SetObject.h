@@ -0,0 +1,96 @@
+#pragma once
+#include <vector>
+#include <unordered_set>
+#include "ScriptObject.h"
+#include "ArrayObject.h"
+
+namespace script
+{
+	/// \brief set of script objects that are compared with equals() and hashCode(). Members will be cloned on insertion.
+	/// Sets that only contain IntObjects store the plain integers in a sorted vector, which makes the bulk
+	/// operations (union, intersection, difference) linear merges
+	class SetObject final : public ScriptObject
+	{
+	public:
+		SetObject();
+		/// \brief adds all elements of the array
+		explicit SetObject(const ArrayObject& values);
+		explicit SetObject(std::vector<int> values);
+		~SetObject() override = default;
+
+		static FunctionT getCtor();
+
+		std::string toString() const override final;
+		void writeTo(OutputSink& sink) const override final;
+		ScriptObjectPtr clone() const override final;
+		/// \brief true if other is a set with the same members
+		bool equals(const ScriptObjectPtr& other) const override final;
+		/// \brief order independent hash of the members
+		size_t hashCode() const override final;
+
+		/// \brief returns true if the value was not part of the set
+		bool add(const ScriptObjectPtr& value);
+		void addAll(const ArrayObject& values);
+		bool has(const ScriptObjectPtr& value) const;
+		/// \brief returns true if the value was removed
+		bool remove(const ScriptObjectPtr& value);
+		void clear();
+		int getCount() const;
+		/// \brief returns the members (integer sets are sorted)
+		ArrayObjectPtr toArray() const;
+
+		/// \brief returns a new set with the members of this and other
+		ScriptPtr<SetObject> getUnion(const SetObject& other) const;
+		/// \brief returns a new set with the members that are part of this and other
+		ScriptPtr<SetObject> getIntersection(const SetObject& other) const;
+		/// \brief returns a new set with the members of this that are not part of other
+		ScriptPtr<SetObject> getDifference(const SetObject& other) const;
+
+		/// \brief indicates if the members are stored as sorted integers
+		bool isFlat() const;
+
+		/// \brief calls func(member) for every member
+		template<class TFunc>
+		void forEach(TFunc func) const
+		{
+			if (m_flat)
+			{
+				for (int v : m_ints)
+					func(makeInt(v));
+				return;
+			}
+			for (const auto& v : m_objects)
+				func(v);
+		}
+	private:
+		struct Hasher
+		{
+			size_t operator()(const ScriptObjectPtr& value) const
+			{
+				return value->hashCode();
+			}
+		};
+		struct Equal
+		{
+			bool operator()(const ScriptObjectPtr& left, const ScriptObjectPtr& right) const
+			{
+				return left.get() == right.get() || left->equals(right);
+			}
+		};
+
+		void setFunctions();
+		/// \brief moves the integers into the generic storage
+		void unflatten();
+		/// \brief returns true if value is an IntObject and stores its value in result
+		static bool getInt(const ScriptObjectPtr& value, int& result);
+		static ScriptObjectPtr makeInt(int value);
+
+		bool m_flat = true;
+		// sorted and unique members if m_flat
+		std::vector<int> m_ints;
+		// members if !m_flat
+		std::unordered_set<ScriptObjectPtr, Hasher, Equal> m_objects;
+	};
+
+	using SetObjectPtr = ScriptPtr<SetObject>;
+}
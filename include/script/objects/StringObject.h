@@ -1,21 +1,72 @@
 #pragma once
-#include "ValueComparableObject.h"
+#include <string_view>
+#include <atomic>
+#include "GetValueObject.h"
 #include "ArrayObject.h"
 
 namespace script
 {
-	class StringObject final : public ValueComparableObject<std::string>
+	/// \brief string that is stored as a chain of immutable chunks followed by a private tail.
+	/// Clones share the chunks and copy only the tail (less than ChunkSize characters after an append),
+	/// so s = s + x costs O(|x|). The chunks are flattened lazily when the whole value is read
+	class StringObject final : public GetValueObject<std::string>
 	{
 	public:
+		/// \brief the tail is sealed into an immutable chunk once it has this many characters
+		static constexpr size_t ChunkSize = 1024;
+
 		explicit StringObject(std::string value);
+		/// \brief shares the immutable payload (e.g. an interned literal) until the string is modified
+		explicit StringObject(std::shared_ptr<const std::string> value);
 		~StringObject() override final = default;
 
 		static FunctionT getCtor();
 
 		std::string toString() const override final;
+		void writeTo(OutputSink& sink) const override final;
 		ScriptObjectPtr clone() const final override;
+		bool equals(const ScriptObjectPtr& other) const override final;
+		/// \brief hash of the characters. Cached until the string is modified
+		size_t hashCode() const override final;
+
+		/// \brief returns a modifiable reference. The string is flattened and will be copied on clone from now on
+		std::string& getValue() override final;
+		/// \brief returns the value without detaching it. Flattens the chunks on first use. Invalidated by the next append
+		std::string_view getView() const;
 
 		ScriptObjectPtr add(const ArrayObjectPtr& args);
+		void append(std::string_view text);
 		int getLength() const;
+	private:
+		struct Chunk
+		{
+			Chunk(std::shared_ptr<const std::string> text, size_t length, std::shared_ptr<const Chunk> prev);
+			/// \brief releases the chain iteratively (long chains would overflow the stack)
+			~Chunk();
+
+			std::shared_ptr<const std::string> text;
+			// length of the string up to and including this chunk
+			size_t length;
+			// previous chunk or nullptr. Only modified by the destructor
+			mutable std::shared_ptr<const Chunk> prev;
+		};
+
+		StringObject(std::shared_ptr<const Chunk> chunks, std::string tail, std::shared_ptr<const std::string> flat);
+		void setFunctions();
+		size_t size() const;
+		/// \brief moves the tail into a new chunk
+		void seal();
+
+		// last sealed chunk or nullptr
+		std::shared_ptr<const Chunk> m_chunks;
+		std::string m_tail;
+		// flattened chunks + tail or nullptr. atomic: getView() may be called by several threads
+		mutable std::atomic<std::shared_ptr<const std::string>> m_flat;
+		// getValue() returned a reference to the tail => the tail holds the whole string and is never sealed
+		bool m_exposed = false;
+		// cached hashCode() or NoHash (only used while the string is not exposed).
+		// atomic: containers may be hashed by several threads
+		static constexpr size_t NoHash = 0;
+		mutable std::atomic<size_t> m_hash{ NoHash };
 	};
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "ValueObject.h"
+#include "../Hash.h"
 
 namespace script
 {
@@ -19,6 +20,11 @@ namespace script
 			// only compare value
 			return this->m_value == vco->m_value;
 		}
+
+		size_t hashCode() const override
+		{
+			return hash::value(this->m_value);
+		}
 	protected:
 		explicit ValueComparableObject(T value)
 			:
@@ -13,6 +13,7 @@ namespace script
 		std::string toString() const override;
 		ScriptObjectPtr clone() const override;
 		bool equals(const ScriptObjectPtr& other) const override;
+		size_t hashCode() const override;
 
 		int getSecond() const;
 		int getMinute() const;
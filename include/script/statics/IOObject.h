@@ -25,17 +25,30 @@ namespace script
 		/// \param data 
 		void appendFile(const std::string& filename, const std::string& data) const;
 
-		/// \brief opens the file and executes line by line with the script engine
+		/// \brief maps the file into memory and executes the statements (separated by ;) with the script engine.
+		/// The statements are compiled in chunks on the thread pool of the engine and executed in order
 		/// \param filename 
 		/// \return the result of the last line
 		ScriptObjectPtr executeFile(const std::string& filename);
 
+		/// \brief compiles the script file and saves the compiled statements as image (see ScriptImage)
+		void compileFile(const std::string& scriptFile, const std::string& imageFile) const;
+
+		/// \brief executes the statements of an image that was created by compileFile without parsing them
+		/// \return the result of the last statement
+		ScriptObjectPtr executeImage(const std::string& filename);
+
 		/// \brief indicates if executeFile() should output the command before executing it
 		void setExecuteDebugOutput(bool enable);
 		
 		/// \brief indicates if executeFile() should output the command before executing it
 		bool getExecuteDebugOutput() const;
 	private:
+		// statements per task of the parallel compilation
+		static constexpr size_t CompileGrainSize = 64;
+		// statements that are compiled before they are executed (bounds the memory of large files)
+		static constexpr size_t ChunkSize = 4096;
+
 		void writeOstream(const std::string& filename, const std::string& data, std::ios_base::openmode mode) const;
 
 		ScriptEngine& m_engine;
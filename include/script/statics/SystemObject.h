@@ -14,5 +14,9 @@ namespace script
 		/// \brief this functions does nothing. it return a NullObject
 		/// you can use this if you don't want to output a result on the console
 		ScriptObjectPtr silent(const ScriptObjectPtr&) const;
+
+		/// \brief suspends the ResumableScript that executes this statement after the statement.
+		/// Returns false if the statement is not executed by a ResumableScript
+		bool yield() const;
 	};
 }
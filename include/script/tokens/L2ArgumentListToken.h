@@ -7,6 +7,7 @@ namespace script
 	{
 	public:
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 		void add(std::unique_ptr<L2Token> value);
 
 	private:
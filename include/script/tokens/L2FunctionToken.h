@@ -9,6 +9,7 @@ namespace script
 		L2FunctionToken(std::unique_ptr<L2Token> value, std::string name, size_t position,
 			std::unique_ptr<L2Token> args);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 	private:
 		std::unique_ptr<L2Token> m_value;
 		size_t m_position;
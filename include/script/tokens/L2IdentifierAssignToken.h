@@ -8,6 +8,7 @@ namespace script
 	public:
 		L2IdentifierAssignToken(std::string name, std::unique_ptr<L2Token> value);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 
 	private:
 		std::string m_name;
@@ -17,6 +17,7 @@ namespace script
 			std::string funcName,
 			bool clone, std::string opSign);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 
 	private:
 		std::unique_ptr<L2Token> m_left;
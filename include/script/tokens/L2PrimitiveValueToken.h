@@ -1,5 +1,8 @@
 #pragma once
 #include "L2Token.h"
+#include "../ScriptImage.h"
+#include <cstring>
+#include <type_traits>
 
 namespace script
 {
@@ -15,6 +18,21 @@ namespace script
 		{
 			return Util::makeObject<T>(m_value);
 		}
+		uint32_t write(ScriptImageWriter& writer) const override
+		{
+			if constexpr (std::is_same_v<T, int>)
+				return writer.addNode(image::NodeType::Int, 0, uint32_t(m_value));
+			else if constexpr (std::is_same_v<T, float>)
+			{
+				uint32_t bits;
+				std::memcpy(&bits, &m_value, sizeof(bits));
+				return writer.addNode(image::NodeType::Float, 0, bits);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+				return writer.addNode(image::NodeType::Bool, 0, m_value ? 1 : 0);
+			else
+				return writer.addNode(image::NodeType::Null, 0);
+		}
 	private:
 		T m_value;
 	};
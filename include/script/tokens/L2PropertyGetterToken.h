@@ -8,6 +8,7 @@ namespace script
 	public:
 		L2PropertyGetterToken(std::unique_ptr<L2Token> object, std::string propName, size_t position);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 
 	private:
 		std::unique_ptr<L2Token> m_object;
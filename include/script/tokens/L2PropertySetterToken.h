@@ -9,6 +9,7 @@ namespace script
 		L2PropertySetterToken(std::unique_ptr<L2Token> object, std::unique_ptr<L2Token> arg, std::string propName,
 			size_t position);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 
 	private:
 		std::unique_ptr<L2Token> m_object;
@@ -8,6 +8,7 @@ namespace script
 	public:
 		L2StaticFunctionToken(std::string name, size_t position, std::unique_ptr<L2Token> args);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 	private:
 		size_t m_position;
 		std::string m_funcName;
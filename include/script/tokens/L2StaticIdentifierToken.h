@@ -8,6 +8,7 @@ namespace script
 	public:
 		L2StaticIdentifierToken(std::string name, size_t position);
 		ScriptObjectPtr execute(ScriptEngine& engine) const override;
+		uint32_t write(ScriptImageWriter& writer) const override;
 
 	private:
 		std::string m_name;
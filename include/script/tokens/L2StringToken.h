@@ -0,0 +1,27 @@
+#pragma once
+#include "L2Token.h"
+#include "../objects/StringObject.h"
+#include "../ScriptImage.h"
+
+namespace script
+{
+	/// \brief string literal. The created StringObjects share the (interned) payload until they are modified
+	class L2StringToken final : public L2Token
+	{
+	public:
+		explicit L2StringToken(std::shared_ptr<const std::string> value)
+			:
+			m_value(std::move(value))
+		{}
+		ScriptObjectPtr execute(ScriptEngine&) const override
+		{
+			return std::make_shared<StringObject>(m_value);
+		}
+		uint32_t write(ScriptImageWriter& writer) const override
+		{
+			return writer.addNode(image::NodeType::String, 0, writer.addString(*m_value));
+		}
+	private:
+		std::shared_ptr<const std::string> m_value;
+	};
+}
@@ -1,13 +1,18 @@
 #pragma once
 #include <string>
+#include <cstdint>
 #include "../ScriptEngine.h"
 
 namespace script
 {
+	class ScriptImageWriter;
+
 	class L2Token
 	{
 	public:
 		virtual ~L2Token() = default;
 		virtual ScriptObjectPtr execute(ScriptEngine& engine) const = 0;
+		/// \brief adds the token and its children to the image. Returns the node index
+		virtual uint32_t write(ScriptImageWriter& writer) const = 0;
 	};
 }
@@ -114,3 +114,21 @@ ParseError(position)
 	stream << "bracket mismatch: expected " << expected << " but got " << found;
 }
 
+script::ExecutionAbortedException::ExecutionAbortedException(Reason reason)
+	:
+reason(reason)
+{
+	stream << "execution aborted: ";
+	switch (reason)
+	{
+	case Reason::StepLimit:
+		stream << "step limit exceeded";
+		break;
+	case Reason::Deadline:
+		stream << "deadline exceeded";
+		break;
+	case Reason::Cancelled:
+		stream << "cancelled";
+		break;
+	}
+}
@@ -0,0 +1,96 @@
+#include "../../include/script/MappedFile.h"
+#include <stdexcept>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+script::MappedFile::MappedFile(const std::string& filename)
+{
+	const auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("could not open file " + filename);
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		throw std::runtime_error("could not open file " + filename);
+	}
+	m_size = size_t(size.QuadPart);
+	if (m_size == 0)
+	{
+		// empty files can not be mapped
+		CloseHandle(file);
+		return;
+	}
+
+	// the mapping keeps the file open
+	m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (m_mapping == nullptr)
+		throw std::runtime_error("could not map file " + filename);
+
+	m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_data == nullptr)
+	{
+		CloseHandle(m_mapping);
+		throw std::runtime_error("could not map file " + filename);
+	}
+}
+
+script::MappedFile::~MappedFile()
+{
+	if (m_data)
+		UnmapViewOfFile(m_data);
+	if (m_mapping)
+		CloseHandle(m_mapping);
+}
+
+#else
+
+script::MappedFile::MappedFile(const std::string& filename)
+{
+	const int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		throw std::runtime_error("could not open file " + filename);
+
+	struct stat info;
+	if (fstat(file, &info) != 0)
+	{
+		close(file);
+		throw std::runtime_error("could not open file " + filename);
+	}
+	m_size = size_t(info.st_size);
+	if (m_size == 0)
+	{
+		// empty files can not be mapped
+		close(file);
+		return;
+	}
+
+	// the mapping keeps the file open
+	const auto data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+		throw std::runtime_error("could not map file " + filename);
+
+	madvise(data, m_size, MADV_SEQUENTIAL);
+	m_data = static_cast<const char*>(data);
+}
+
+script::MappedFile::~MappedFile()
+{
+	if (m_data)
+		munmap(const_cast<char*>(m_data), m_size);
+}
+
+#endif
@@ -0,0 +1,737 @@
+#include "../../include/script/NumericKernels.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SCRIPT_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SCRIPT_KERNELS_X86) && !defined(_MSC_VER)
+// gcc and clang only allow intrinsics of instruction sets that are enabled for the function.
+// FMA is not enabled: the compiler would contract a multiply and an add into a fused multiply-add
+#define SCRIPT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SCRIPT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SCRIPT_TARGET_SSE41
+#define SCRIPT_TARGET_AVX2
+#endif
+
+using script::kernels::InstructionSet;
+
+namespace
+{
+	std::atomic<InstructionSet>& currentInstructionSet()
+	{
+		static std::atomic<InstructionSet> set(script::kernels::getSupportedInstructionSet());
+		return set;
+	}
+
+#pragma region Operations
+
+	struct AddOp
+	{
+		template<class T>
+		static T scalar(T a, T b) { return a + b; }
+		// unsigned arithmetic wraps like _mm_add_epi32 (e.g. INT_MAX + 1)
+		static int scalar(int a, int b) { return int(unsigned(a) + unsigned(b)); }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+#endif
+	};
+
+	struct SubtractOp
+	{
+		template<class T>
+		static T scalar(T a, T b) { return a - b; }
+		// unsigned arithmetic wraps like _mm_sub_epi32 (e.g. INT_MIN - 1)
+		static int scalar(int a, int b) { return int(unsigned(a) - unsigned(b)); }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i a, __m256i b) { return _mm256_sub_epi32(a, b); }
+#endif
+	};
+
+	struct MultiplyOp
+	{
+		template<class T>
+		static T scalar(T a, T b) { return a * b; }
+		// unsigned arithmetic wraps like _mm_mullo_epi32 (e.g. INT_MIN * -1)
+		static int scalar(int a, int b) { return int(unsigned(a) * unsigned(b)); }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i a, __m128i b) { return _mm_mullo_epi32(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i a, __m256i b) { return _mm256_mullo_epi32(a, b); }
+#endif
+	};
+
+	// there is no integer division instruction => integers will always use the scalar version.
+	// The caller rejects division by zero and INT_MIN / -1
+	struct DivideOp
+	{
+		template<class T>
+		static T scalar(T a, T b) { return a / b; }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+#endif
+	};
+
+	// the second operand will be ignored
+	struct AbsOp
+	{
+		static float scalar(float a, float) { return std::fabs(a); }
+		// unsigned arithmetic wraps like _mm_abs_epi32 (abs(INT_MIN) = INT_MIN)
+		static int scalar(int a, int) { return int(a < 0 ? 0u - unsigned(a) : unsigned(a)); }
+#ifdef SCRIPT_KERNELS_X86
+		// clear the sign bit
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 a, __m128) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i a, __m128i) { return _mm_abs_epi32(a); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 a, __m256) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i a, __m256i) { return _mm256_abs_epi32(a); }
+#endif
+	};
+
+	struct ClampOp
+	{
+		// same NaN handling as the max/min instructions (NaN => low)
+		template<class T>
+		static T scalar(T v, T low, T high)
+		{
+			const T res = v > low ? v : low;
+			return res < high ? res : high;
+		}
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 v, __m128 low, __m128 high) { return _mm_min_ps(_mm_max_ps(v, low), high); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i v, __m128i low, __m128i high) { return _mm_min_epi32(_mm_max_epi32(v, low), high); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 v, __m256 low, __m256 high) { return _mm256_min_ps(_mm256_max_ps(v, low), high); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i v, __m256i low, __m256i high) { return _mm256_min_epi32(_mm256_max_epi32(v, low), high); }
+#endif
+	};
+
+	// no fused multiply-add: the product is rounded before the addition in every path
+	// (the vector body and the scalar remainder must return the same result)
+	struct MultiplyAddOp
+	{
+		template<class T>
+		static T scalar(T v, T mul, T add)
+		{
+			const T product = v * mul;
+			return product + add;
+		}
+		// unsigned arithmetic wraps like _mm_mullo_epi32 and _mm_add_epi32
+		static int scalar(int v, int mul, int add) { return int(unsigned(v) * unsigned(mul) + unsigned(add)); }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 v, __m128 mul, __m128 add) { return _mm_add_ps(_mm_mul_ps(v, mul), add); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i v, __m128i mul, __m128i add) { return _mm_add_epi32(_mm_mullo_epi32(v, mul), add); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 v, __m256 mul, __m256 add) { return _mm256_add_ps(_mm256_mul_ps(v, mul), add); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i v, __m256i mul, __m256i add) { return _mm256_add_epi32(_mm256_mullo_epi32(v, mul), add); }
+#endif
+	};
+
+#pragma endregion
+
+#pragma region Scalar Loops
+
+	// dst[i] = op(dst[i], src[i])
+	template<class Op, class T>
+	void arrayScalar(T* dst, const T* src, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], src[i]);
+	}
+
+	// dst[i] = op(dst[i], value)
+	template<class Op, class T>
+	void valueScalar(T* dst, T value, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], value);
+	}
+
+	// dst[i] = op(dst[i], a, b)
+	template<class Op, class T>
+	void value2Scalar(T* dst, T a, T b, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a, b);
+	}
+
+	// dst[i] = op(dst[i], a[i], b[i])
+	template<class Op, class T>
+	void array2Scalar(T* dst, const T* a, const T* b, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a[i], b[i]);
+	}
+
+#pragma endregion
+
+#ifdef SCRIPT_KERNELS_X86
+
+#pragma region SSE Loops
+
+	SCRIPT_TARGET_SSE41 inline __m128 load4(const float* src) { return _mm_loadu_ps(src); }
+	SCRIPT_TARGET_SSE41 inline __m128i load4(const int* src) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)); }
+	SCRIPT_TARGET_SSE41 inline void store4(float* dst, __m128 value) { _mm_storeu_ps(dst, value); }
+	SCRIPT_TARGET_SSE41 inline void store4(int* dst, __m128i value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value); }
+	SCRIPT_TARGET_SSE41 inline __m128 set4(float value) { return _mm_set1_ps(value); }
+	SCRIPT_TARGET_SSE41 inline __m128i set4(int value) { return _mm_set1_epi32(value); }
+
+	template<class Op, class T>
+	SCRIPT_TARGET_SSE41 void arraySse(T* dst, const T* src, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			store4(dst + i, Op::sse(load4(dst + i), load4(src + i)));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], src[i]);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_SSE41 void valueSse(T* dst, T value, size_t count)
+	{
+		const auto v = set4(value);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			store4(dst + i, Op::sse(load4(dst + i), v));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], value);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_SSE41 void value2Sse(T* dst, T a, T b, size_t count)
+	{
+		const auto va = set4(a);
+		const auto vb = set4(b);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			store4(dst + i, Op::sse(load4(dst + i), va, vb));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a, b);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_SSE41 void array2Sse(T* dst, const T* a, const T* b, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			store4(dst + i, Op::sse(load4(dst + i), load4(a + i), load4(b + i)));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a[i], b[i]);
+	}
+
+#pragma endregion
+
+#pragma region AVX Loops
+
+	SCRIPT_TARGET_AVX2 inline __m256 load8(const float* src) { return _mm256_loadu_ps(src); }
+	SCRIPT_TARGET_AVX2 inline __m256i load8(const int* src) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)); }
+	SCRIPT_TARGET_AVX2 inline void store8(float* dst, __m256 value) { _mm256_storeu_ps(dst, value); }
+	SCRIPT_TARGET_AVX2 inline void store8(int* dst, __m256i value) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), value); }
+	SCRIPT_TARGET_AVX2 inline __m256 set8(float value) { return _mm256_set1_ps(value); }
+	SCRIPT_TARGET_AVX2 inline __m256i set8(int value) { return _mm256_set1_epi32(value); }
+
+	template<class Op, class T>
+	SCRIPT_TARGET_AVX2 void arrayAvx(T* dst, const T* src, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			store8(dst + i, Op::avx(load8(dst + i), load8(src + i)));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], src[i]);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_AVX2 void valueAvx(T* dst, T value, size_t count)
+	{
+		const auto v = set8(value);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			store8(dst + i, Op::avx(load8(dst + i), v));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], value);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_AVX2 void value2Avx(T* dst, T a, T b, size_t count)
+	{
+		const auto va = set8(a);
+		const auto vb = set8(b);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			store8(dst + i, Op::avx(load8(dst + i), va, vb));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a, b);
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_AVX2 void array2Avx(T* dst, const T* a, const T* b, size_t count)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			store8(dst + i, Op::avx(load8(dst + i), load8(a + i), load8(b + i)));
+		for (; i < count; ++i)
+			dst[i] = Op::scalar(dst[i], a[i], b[i]);
+	}
+
+#pragma endregion
+
+#endif
+
+#pragma region Dispatch
+
+	template<class Op, class T>
+	void dispatchArray(T* dst, const T* src, size_t count)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return arrayAvx<Op>(dst, src, count);
+		case InstructionSet::SSE41: return arraySse<Op>(dst, src, count);
+#endif
+		default: return arrayScalar<Op>(dst, src, count);
+		}
+	}
+
+	template<class Op, class T>
+	void dispatchValue(T* dst, T value, size_t count)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return valueAvx<Op>(dst, value, count);
+		case InstructionSet::SSE41: return valueSse<Op>(dst, value, count);
+#endif
+		default: return valueScalar<Op>(dst, value, count);
+		}
+	}
+
+	template<class Op, class T>
+	void dispatchValue2(T* dst, T a, T b, size_t count)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return value2Avx<Op>(dst, a, b, count);
+		case InstructionSet::SSE41: return value2Sse<Op>(dst, a, b, count);
+#endif
+		default: return value2Scalar<Op>(dst, a, b, count);
+		}
+	}
+
+	template<class Op, class T>
+	void dispatchArray2(T* dst, const T* a, const T* b, size_t count)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return array2Avx<Op>(dst, a, b, count);
+		case InstructionSet::SSE41: return array2Sse<Op>(dst, a, b, count);
+#endif
+		default: return array2Scalar<Op>(dst, a, b, count);
+		}
+	}
+
+#pragma endregion
+}
+
+namespace
+{
+#pragma region Reduction Operations
+
+	// accumulates the elements (converted to float)
+	struct SumReduce
+	{
+		float scalar(float acc, float v) const { return acc + v; }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 __m128 sse(__m128 acc, __m128 v) const { return _mm_add_ps(acc, v); }
+		SCRIPT_TARGET_AVX2 __m256 avx(__m256 acc, __m256 v) const { return _mm256_add_ps(acc, v); }
+#endif
+	};
+
+	// accumulates (v - mean)^2. Rounds like MultiplyAddOp (no fused multiply-add)
+	struct SquaredDeviationReduce
+	{
+		float mean;
+
+		float scalar(float acc, float v) const
+		{
+			const float d = v - mean;
+			const float square = d * d;
+			return acc + square;
+		}
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 __m128 sse(__m128 acc, __m128 v) const
+		{
+			const __m128 d = _mm_sub_ps(v, _mm_set1_ps(mean));
+			return _mm_add_ps(acc, _mm_mul_ps(d, d));
+		}
+		SCRIPT_TARGET_AVX2 __m256 avx(__m256 acc, __m256 v) const
+		{
+			const __m256 d = _mm256_sub_ps(v, _mm256_set1_ps(mean));
+			return _mm256_add_ps(acc, _mm256_mul_ps(d, d));
+		}
+#endif
+	};
+
+	// the vector instructions return the second operand if one operand is NaN => NaN values of v are ignored
+	struct MinReduce
+	{
+		template<class T>
+		static T init() { return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max(); }
+		template<class T>
+		static T scalar(T acc, T v) { return v < acc ? v : acc; }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 acc, __m128 v) { return _mm_min_ps(v, acc); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i acc, __m128i v) { return _mm_min_epi32(v, acc); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 acc, __m256 v) { return _mm256_min_ps(v, acc); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i acc, __m256i v) { return _mm256_min_epi32(v, acc); }
+#endif
+	};
+
+	struct MaxReduce
+	{
+		template<class T>
+		static T init() { return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest(); }
+		template<class T>
+		static T scalar(T acc, T v) { return v > acc ? v : acc; }
+#ifdef SCRIPT_KERNELS_X86
+		SCRIPT_TARGET_SSE41 static __m128 sse(__m128 acc, __m128 v) { return _mm_max_ps(v, acc); }
+		SCRIPT_TARGET_SSE41 static __m128i sse(__m128i acc, __m128i v) { return _mm_max_epi32(v, acc); }
+		SCRIPT_TARGET_AVX2 static __m256 avx(__m256 acc, __m256 v) { return _mm256_max_ps(v, acc); }
+		SCRIPT_TARGET_AVX2 static __m256i avx(__m256i acc, __m256i v) { return _mm256_max_epi32(v, acc); }
+#endif
+	};
+
+#pragma endregion
+
+#pragma region Reduction Loops
+
+	// number of elements that will be accumulated sequentially by the pairwise summation
+	constexpr size_t PairwiseBlockSize = 128;
+
+	template<class Op, class S>
+	float reduceScalar(const S* src, size_t count, const Op& op)
+	{
+		float acc = 0.0f;
+		for (size_t i = 0; i < count; ++i)
+			acc = op.scalar(acc, float(src[i]));
+		return acc;
+	}
+
+	template<class Op, class T>
+	T extremeScalar(const T* src, size_t count)
+	{
+		T acc = Op::template init<T>();
+		for (size_t i = 0; i < count; ++i)
+			acc = Op::scalar(acc, src[i]);
+		return acc;
+	}
+
+	long long sumScalar(const int* src, size_t count)
+	{
+		long long acc = 0;
+		for (size_t i = 0; i < count; ++i)
+			acc += src[i];
+		return acc;
+	}
+
+#ifdef SCRIPT_KERNELS_X86
+
+	SCRIPT_TARGET_SSE41 inline __m128 loadFloat4(const float* src) { return _mm_loadu_ps(src); }
+	SCRIPT_TARGET_SSE41 inline __m128 loadFloat4(const int* src) { return _mm_cvtepi32_ps(load4(src)); }
+	SCRIPT_TARGET_AVX2 inline __m256 loadFloat8(const float* src) { return _mm256_loadu_ps(src); }
+	SCRIPT_TARGET_AVX2 inline __m256 loadFloat8(const int* src) { return _mm256_cvtepi32_ps(load8(src)); }
+
+	template<class Op, class S>
+	SCRIPT_TARGET_SSE41 float reduceSse(const S* src, size_t count, const Op& op)
+	{
+		// two accumulators to hide the add latency
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			acc0 = op.sse(acc0, loadFloat4(src + i));
+			acc1 = op.sse(acc1, loadFloat4(src + i + 4));
+		}
+		for (; i + 4 <= count; i += 4)
+			acc0 = op.sse(acc0, loadFloat4(src + i));
+
+		alignas(16) float lanes[4];
+		_mm_store_ps(lanes, _mm_add_ps(acc0, acc1));
+		float res = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+		for (; i < count; ++i)
+			res = op.scalar(res, float(src[i]));
+		return res;
+	}
+
+	template<class Op, class S>
+	SCRIPT_TARGET_AVX2 float reduceAvx(const S* src, size_t count, const Op& op)
+	{
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			acc0 = op.avx(acc0, loadFloat8(src + i));
+			acc1 = op.avx(acc1, loadFloat8(src + i + 8));
+		}
+		for (; i + 8 <= count; i += 8)
+			acc0 = op.avx(acc0, loadFloat8(src + i));
+
+		alignas(32) float lanes[8];
+		_mm256_store_ps(lanes, _mm256_add_ps(acc0, acc1));
+		float res = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+		for (; i < count; ++i)
+			res = op.scalar(res, float(src[i]));
+		return res;
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_SSE41 T extremeSse(const T* src, size_t count)
+	{
+		const T init = Op::template init<T>();
+		auto acc = set4(init);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+			acc = Op::sse(acc, load4(src + i));
+
+		T lanes[4];
+		store4(lanes, acc);
+		T res = init;
+		for (T lane : lanes)
+			res = Op::scalar(res, lane);
+		for (; i < count; ++i)
+			res = Op::scalar(res, src[i]);
+		return res;
+	}
+
+	template<class Op, class T>
+	SCRIPT_TARGET_AVX2 T extremeAvx(const T* src, size_t count)
+	{
+		const T init = Op::template init<T>();
+		auto acc = set8(init);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+			acc = Op::avx(acc, load8(src + i));
+
+		T lanes[8];
+		store8(lanes, acc);
+		T res = init;
+		for (T lane : lanes)
+			res = Op::scalar(res, lane);
+		for (; i < count; ++i)
+			res = Op::scalar(res, src[i]);
+		return res;
+	}
+
+	// integers are widened to 64 bit to prevent overflows
+	SCRIPT_TARGET_SSE41 long long sumSse(const int* src, size_t count)
+	{
+		__m128i acc = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i v = load4(src + i);
+			acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+			acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+		}
+
+		alignas(16) long long lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+		return lanes[0] + lanes[1] + sumScalar(src + i, count - i);
+	}
+
+	SCRIPT_TARGET_AVX2 long long sumAvx(const int* src, size_t count)
+	{
+		__m256i acc = _mm256_setzero_si256();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i v = load8(src + i);
+			acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+			acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+		}
+
+		alignas(32) long long lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+		return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sumScalar(src + i, count - i);
+	}
+
+#endif
+
+	// splits the range until the blocks are small enough to be reduced sequentially
+	template<class Op, class S, class Block>
+	float pairwise(const S* src, size_t count, const Op& op, Block block)
+	{
+		if (count <= PairwiseBlockSize)
+			return block(src, count, op);
+
+		// multiple of 16 to keep the vector loops busy
+		const size_t half = (count / 2) & ~size_t(15);
+		return pairwise(src, half, op, block) + pairwise(src + half, count - half, op, block);
+	}
+
+#pragma endregion
+
+#pragma region Reduction Dispatch
+
+	template<class Op, class S>
+	float dispatchReduce(const S* src, size_t count, const Op& op)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return pairwise(src, count, op, &reduceAvx<Op, S>);
+		case InstructionSet::SSE41: return pairwise(src, count, op, &reduceSse<Op, S>);
+#endif
+		default: return pairwise(src, count, op, &reduceScalar<Op, S>);
+		}
+	}
+
+	template<class Op, class T>
+	T dispatchExtreme(const T* src, size_t count)
+	{
+		switch (currentInstructionSet().load(std::memory_order_relaxed))
+		{
+#ifdef SCRIPT_KERNELS_X86
+		case InstructionSet::AVX2: return extremeAvx<Op>(src, count);
+		case InstructionSet::SSE41: return extremeSse<Op>(src, count);
+#endif
+		default: return extremeScalar<Op>(src, count);
+		}
+	}
+
+	// NaN values are ignored => the initial value (infinity) is returned if all values are NaN
+	template<class Op>
+	float dispatchExtremeFloat(const float* src, size_t count)
+	{
+		const float res = dispatchExtreme<Op>(src, count);
+		// the array only contains the initial value if one of the elements is infinity
+		if (res == Op::template init<float>() && std::find(src, src + count, res) == src + count)
+			return std::numeric_limits<float>::quiet_NaN();
+		return res;
+	}
+
+#pragma endregion
+}
+
+InstructionSet script::kernels::getInstructionSet()
+{
+	return currentInstructionSet().load();
+}
+
+InstructionSet script::kernels::getSupportedInstructionSet()
+{
+#if defined(SCRIPT_KERNELS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	if (maxLeaf < 1)
+		return InstructionSet::Scalar;
+
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	// the operating system must save the ymm registers
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx2 = false;
+	if (maxLeaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+
+	if (avx2) return InstructionSet::AVX2;
+	if (sse41) return InstructionSet::SSE41;
+	return InstructionSet::Scalar;
+#elif defined(SCRIPT_KERNELS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return InstructionSet::AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return InstructionSet::SSE41;
+	return InstructionSet::Scalar;
+#else
+	return InstructionSet::Scalar;
+#endif
+}
+
+void script::kernels::setInstructionSet(InstructionSet set)
+{
+	const auto supported = getSupportedInstructionSet();
+	if (int(set) > int(supported))
+		set = supported;
+
+	currentInstructionSet().store(set);
+}
+
+void script::kernels::add(float* dst, float value, size_t count) { dispatchValue<AddOp>(dst, value, count); }
+void script::kernels::add(float* dst, const float* src, size_t count) { dispatchArray<AddOp>(dst, src, count); }
+void script::kernels::add(int* dst, int value, size_t count) { dispatchValue<AddOp>(dst, value, count); }
+void script::kernels::add(int* dst, const int* src, size_t count) { dispatchArray<AddOp>(dst, src, count); }
+
+void script::kernels::subtract(float* dst, float value, size_t count) { dispatchValue<SubtractOp>(dst, value, count); }
+void script::kernels::subtract(float* dst, const float* src, size_t count) { dispatchArray<SubtractOp>(dst, src, count); }
+void script::kernels::subtract(int* dst, int value, size_t count) { dispatchValue<SubtractOp>(dst, value, count); }
+void script::kernels::subtract(int* dst, const int* src, size_t count) { dispatchArray<SubtractOp>(dst, src, count); }
+
+void script::kernels::multiply(float* dst, float value, size_t count) { dispatchValue<MultiplyOp>(dst, value, count); }
+void script::kernels::multiply(float* dst, const float* src, size_t count) { dispatchArray<MultiplyOp>(dst, src, count); }
+void script::kernels::multiply(int* dst, int value, size_t count) { dispatchValue<MultiplyOp>(dst, value, count); }
+void script::kernels::multiply(int* dst, const int* src, size_t count) { dispatchArray<MultiplyOp>(dst, src, count); }
+
+void script::kernels::divide(float* dst, float value, size_t count) { dispatchValue<DivideOp>(dst, value, count); }
+void script::kernels::divide(float* dst, const float* src, size_t count) { dispatchArray<DivideOp>(dst, src, count); }
+void script::kernels::divide(int* dst, int value, size_t count) { valueScalar<DivideOp>(dst, value, count); }
+void script::kernels::divide(int* dst, const int* src, size_t count) { arrayScalar<DivideOp>(dst, src, count); }
+
+// -x is exact for floats and wraps like x * -1 for integers
+void script::kernels::negate(float* dst, size_t count) { dispatchValue<MultiplyOp>(dst, -1.0f, count); }
+void script::kernels::negate(int* dst, size_t count) { dispatchValue<MultiplyOp>(dst, -1, count); }
+
+void script::kernels::abs(float* dst, size_t count) { dispatchValue<AbsOp>(dst, 0.0f, count); }
+void script::kernels::abs(int* dst, size_t count) { dispatchValue<AbsOp>(dst, 0, count); }
+
+void script::kernels::clamp(float* dst, float low, float high, size_t count) { dispatchValue2<ClampOp>(dst, low, high, count); }
+void script::kernels::clamp(int* dst, int low, int high, size_t count) { dispatchValue2<ClampOp>(dst, low, high, count); }
+
+void script::kernels::multiplyAdd(float* dst, float mul, float add, size_t count) { dispatchValue2<MultiplyAddOp>(dst, mul, add, count); }
+void script::kernels::multiplyAdd(int* dst, int mul, int add, size_t count) { dispatchValue2<MultiplyAddOp>(dst, mul, add, count); }
+void script::kernels::multiplyAdd(float* dst, const float* mul, const float* add, size_t count) { dispatchArray2<MultiplyAddOp>(dst, mul, add, count); }
+void script::kernels::multiplyAdd(int* dst, const int* mul, const int* add, size_t count) { dispatchArray2<MultiplyAddOp>(dst, mul, add, count); }
+
+float script::kernels::sum(const float* src, size_t count) { return dispatchReduce(src, count, SumReduce()); }
+
+long long script::kernels::sum(const int* src, size_t count)
+{
+	switch (currentInstructionSet().load(std::memory_order_relaxed))
+	{
+#ifdef SCRIPT_KERNELS_X86
+	case InstructionSet::AVX2: return sumAvx(src, count);
+	case InstructionSet::SSE41: return sumSse(src, count);
+#endif
+	default: return sumScalar(src, count);
+	}
+}
+
+float script::kernels::minimum(const float* src, size_t count) { return dispatchExtremeFloat<MinReduce>(src, count); }
+int script::kernels::minimum(const int* src, size_t count) { return dispatchExtreme<MinReduce>(src, count); }
+float script::kernels::maximum(const float* src, size_t count) { return dispatchExtremeFloat<MaxReduce>(src, count); }
+int script::kernels::maximum(const int* src, size_t count) { return dispatchExtreme<MaxReduce>(src, count); }
+
+float script::kernels::sumSquaredDeviation(const float* src, float mean, size_t count) { return dispatchReduce(src, count, SquaredDeviationReduce{ mean }); }
+float script::kernels::sumSquaredDeviation(const int* src, float mean, size_t count) { return dispatchReduce(src, count, SquaredDeviationReduce{ mean }); }
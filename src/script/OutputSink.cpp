@@ -0,0 +1,84 @@
+#include "../../include/script/OutputSink.h"
+
+script::OutputSink::OutputSink(size_t limit)
+	:
+m_limit(limit)
+{}
+
+bool script::OutputSink::write(std::string_view text)
+{
+	const size_t remaining = m_limit - m_size;
+	if (text.size() > remaining)
+	{
+		text = text.substr(0, remaining);
+		m_truncated = true;
+	}
+
+	if (!text.empty())
+	{
+		onWrite(text);
+		m_size += text.size();
+	}
+	return !isFull();
+}
+
+bool script::OutputSink::write(char c)
+{
+	return write(std::string_view(&c, 1));
+}
+
+bool script::OutputSink::isFull() const
+{
+	return m_size >= m_limit;
+}
+
+bool script::OutputSink::isTruncated() const
+{
+	return m_truncated;
+}
+
+void script::OutputSink::setTruncated()
+{
+	m_truncated = true;
+}
+
+size_t script::OutputSink::getSize() const
+{
+	return m_size;
+}
+
+size_t script::OutputSink::getLimit() const
+{
+	return m_limit;
+}
+
+script::StringSink::StringSink(size_t limit)
+	:
+OutputSink(limit)
+{}
+
+const std::string& script::StringSink::getString() const
+{
+	return m_string;
+}
+
+std::string script::StringSink::release()
+{
+	return std::move(m_string);
+}
+
+void script::StringSink::onWrite(std::string_view text)
+{
+	m_string.append(text.data(), text.size());
+}
+
+script::StreamSink::StreamSink(std::ostream& stream, size_t limit)
+	:
+OutputSink(limit),
+m_stream(stream)
+{}
+
+void script::StreamSink::onWrite(std::string_view text)
+{
+	m_stream.write(text.data(), std::streamsize(text.size()));
+}
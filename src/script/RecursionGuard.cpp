@@ -0,0 +1,25 @@
+#include "../../include/script/RecursionGuard.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+	// objects that are visited by the current thread (the nesting depth is small => linear search)
+	thread_local std::vector<std::pair<const void*, script::RecursionGuard::Operation>> s_visited;
+}
+
+script::RecursionGuard::RecursionGuard(const void* object, Operation operation)
+{
+	const auto entry = std::make_pair(object, operation);
+	m_recursive = std::find(s_visited.begin(), s_visited.end(), entry) != s_visited.end();
+	if (!m_recursive)
+		s_visited.push_back(entry);
+}
+
+script::RecursionGuard::~RecursionGuard()
+{
+	// guards are destroyed in reverse order
+	if (!m_recursive)
+		s_visited.pop_back();
+}
@@ -0,0 +1,73 @@
+#include "../../include/script/ResumableScript.h"
+
+namespace
+{
+	thread_local script::ResumableScript* s_current = nullptr;
+}
+
+script::ResumableScript::ResumableScript(ScriptEngine& engine, std::string script)
+	:
+m_engine(engine),
+m_script(move(script)),
+m_reader(m_script),
+m_result(NullObject::get())
+{}
+
+script::ResumableScript::State script::ResumableScript::resume(size_t budget)
+{
+	if (m_state == State::Finished)
+		throw std::runtime_error("ResumableScript::resume script is already finished");
+
+	// scripts may be resumed by statements of other scripts
+	struct CurrentScope
+	{
+		ResumableScript* previous = s_current;
+		~CurrentScope() { s_current = previous; }
+	} scope;
+	s_current = this;
+	m_yield = false;
+
+	// the steps of nested executions are counted by the engine as well
+	const auto start = m_engine.getStepCount();
+	for (;;)
+	{
+		if (m_next == m_statements.size())
+		{
+			m_next = 0;
+			if (!m_reader.read(m_statements, ChunkSize))
+			{
+				m_state = State::Finished;
+				if (m_reader.hasRemainder())
+					throw std::runtime_error("missing ; at the end of the script");
+				return m_state;
+			}
+		}
+		// a yield in the last statement finishes the script as well
+		if (m_yield || m_engine.getStepCount() - start >= uint64_t(budget))
+			return m_state;
+
+		const auto& s = m_statements[m_next++];
+		try
+		{
+			m_result = m_engine.execute(m_engine.compile(s.getCommand(), false));
+		}
+		catch (const ExecutionAbortedException&)
+		{
+			m_state = State::Finished;
+			throw;
+		}
+		catch (std::exception& e)
+		{
+			m_state = State::Finished;
+			throw std::runtime_error("line " + std::to_string(s.line) + std::string(": ") + e.what());
+		}
+		++m_executed;
+	}
+}
+
+bool script::ResumableScript::yield()
+{
+	if (s_current == nullptr) return false;
+	s_current->m_yield = true;
+	return true;
+}
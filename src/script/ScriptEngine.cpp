@@ -1,12 +1,32 @@
 #include "../include/script/ScriptEngine.h"
 #include "../include/script/Tokenizer.h"
 #include "../../include/script/objects/FloatObject.h"
+#include "../../include/script/objects/IntArrayObject.h"
+#include "../../include/script/objects/FloatArrayObject.h"
+#include "../../include/script/objects/MapObject.h"
+#include "../../include/script/objects/SetObject.h"
+#include "../../include/script/objects/RangeObject.h"
 #include "../../include/script/statics/ConsoleObject.h"
 #include "../../include/script/statics/SystemObject.h"
+#include "../../include/script/ScriptExecutor.h"
+#include "../../include/script/ResumableScript.h"
 #include <unordered_set>
+#include <algorithm>
 #include <cassert>
+#include <atomic>
 
-script::ScriptEngine::ScriptEngine(InitFlags flags)
+namespace
+{
+	std::atomic<size_t> s_engineCount{ 0 };
+}
+
+script::ScriptEngine::ScriptEngine(InitFlags flags, Threading threading)
+	:
+m_flags(flags),
+m_id(s_engineCount++),
+m_threading(threading),
+m_staticObjects(std::make_shared<ObjectMap>()),
+m_staticFunctions(std::make_shared<FunctionMap>())
 {
 	if(flags & PrimitiveConstructor)
 	{
@@ -14,6 +34,11 @@ script::ScriptEngine::ScriptEngine(InitFlags flags)
 		setStaticFunction("Float", FloatObject::getCtor());
 		setStaticFunction("Bool", BoolObject::getCtor());
 		setStaticFunction("String", StringObject::getCtor());
+		setStaticFunction("IntArray", IntArrayObject::getCtor());
+		setStaticFunction("FloatArray", FloatArrayObject::getCtor());
+		setStaticFunction("Map", MapObject::getCtor());
+		setStaticFunction("Set", SetObject::getCtor());
+		setStaticFunction("Range", RangeObject::getCtor());
 	}
 
 	if(flags & ConsoleClass)
@@ -38,47 +63,276 @@ script::ScriptEngine::ScriptEngine(InitFlags flags)
 	}
 }
 
+script::ScriptEngine::ScriptEngine(const ScriptEngine& prototype, ForkTag)
+	:
+m_flags(prototype.m_flags),
+m_id(s_engineCount++),
+m_threading(prototype.m_threading),
+m_prototypeObjects(prototype.m_prototypeObjects),
+m_staticObjects(prototype.m_staticObjects.load()),
+m_staticFunctions(prototype.m_staticFunctions.load())
+{
+	// the other statics are shared, these two are bound to the engine instance
+	if (!(m_flags & (IOClass | EngineClass))) return;
+
+	updateSnapshot(m_staticObjects, [this](ObjectMap& objects)
+	{
+		if (m_flags & IOClass)
+			objects["IO"] = std::make_shared<IOObject>(*this);
+		if (m_flags & EngineClass)
+			objects["Engine"] = std::make_shared<EngineObject>(*this);
+	});
+}
+
+script::ScriptEngine::~ScriptEngine()
+{
+	std::unique_lock<std::mutex> lock(m_asyncMutex);
+	m_asyncDone.wait(lock, [this]() { return m_asyncPending == 0; });
+}
+
+void script::ScriptEngine::freeze()
+{
+	if (m_frozen) return;
+
+	m_prototypeObjects = std::make_shared<const ObjectMap>(getObjects());
+	m_frozen = true;
+}
+
+std::unique_ptr<script::ScriptEngine> script::ScriptEngine::fork() const
+{
+	if (!m_frozen)
+		throw std::runtime_error("ScriptEngine::fork engine must be frozen");
+
+	return std::unique_ptr<ScriptEngine>(new ScriptEngine(*this, ForkTag{}));
+}
+
 script::ScriptObjectPtr script::ScriptEngine::execute(const std::string& command)
 {
 	if(command.empty()) return NullObject::get();
+	// report a frozen engine before syntax errors
+	throwIfFrozen("execute");
+
+	return execute(compile(command, false));
+}
 
+script::ScriptEngine::CompiledCommand script::ScriptEngine::compile(std::string_view command, bool copyText)
+{
+	CompiledCommand res;
+	if (command.empty()) return res;
+
+	if (copyText)
+	{
+		res.storage = std::make_shared<const std::string>(command);
+		res.text = *res.storage;
+	}
+	else res.text = command;
+
+	try
+	{
+		res.token = Tokenizer::getExecutable(command, &m_strings);
+	}
+	catch (const ParseError& error)
+	{
+		throw getError(res.text, error);
+	}
+	return res;
+}
+
+script::ScriptObjectPtr script::ScriptEngine::execute(const CompiledCommand& command)
+{
+	if (!command.token) return NullObject::get();
+	throwIfFrozen("execute");
+
+	const ThreadPool::Scope poolScope(&m_threadPool);
 	try
 	{
-		const auto token = Tokenizer::getExecutable(command);
-		const auto res = token->execute(*this);
-		return res;
+		return command.token->execute(*this);
 	}
 	catch (const ParseError& error)
 	{
-		const auto pos = error.position;
-		std::string errorPosition;
-		if(pos == size_t(-1))
+		throw getError(command.text, error);
+	}
+}
+
+std::vector<script::ScriptEngine::BatchResult> script::ScriptEngine::executeBatch(std::span<const std::string> commands, BatchPolicy policy, bool parallelCompile)
+{
+	throwIfFrozen("executeBatch");
+
+	std::vector<CompiledCommand> compiled(commands.size());
+	std::vector<BatchResult> res(commands.size());
+	const auto compileRange = [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
 		{
-			errorPosition = command + "<";
+			try
+			{
+				// the commands outlive the batch
+				compiled[i] = compile(commands[i], false);
+			}
+			catch (...)
+			{
+				res[i].error = std::current_exception();
+			}
 		}
-		else
+	};
+
+	if (parallelCompile)
+		m_threadPool.parallelFor(commands.size(), CompileGrainSize, compileRange);
+	else
+		compileRange(0, commands.size());
+
+	bool aborted = false;
+	for (size_t i = 0; i < commands.size(); ++i)
+	{
+		if (!res[i].error)
 		{
-			// include some parts before and some parts after the error
-			errorPosition = command;
-			errorPosition.insert(pos, ">");
+			try
+			{
+				res[i].value = execute(compiled[i]);
+			}
+			catch (const ExecutionAbortedException&)
+			{
+				// the limits apply to the whole batch
+				res[i].error = std::current_exception();
+				aborted = true;
+			}
+			catch (...)
+			{
+				res[i].error = std::current_exception();
+			}
+		}
+
+		if (res[i].error && (policy == BatchPolicy::StopOnError || aborted))
+		{
+			// the remaining commands were not executed
+			for (size_t j = i + 1; j < res.size(); ++j)
+				res[j].error = nullptr;
+			break;
 		}
-		throw std::runtime_error(error.what() + std::string(" at ") + errorPosition);
 	}
+	return res;
+}
+
+std::future<script::ScriptObjectPtr> script::ScriptEngine::executeAsync(std::string command)
+{
+	return ScriptExecutor::getDefault().submit(*this, move(command));
+}
+
+std::unique_ptr<script::ResumableScript> script::ScriptEngine::executeResumable(std::string script, size_t budget)
+{
+	auto res = std::make_unique<ResumableScript>(*this, move(script));
+	res->resume(budget);
+	return res;
+}
+
+void script::ScriptEngine::setStepLimit(uint64_t steps)
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	updateStepCount();
+	m_stepLimit = steps >= NoStepLimit - m_stepCount ? NoStepLimit : m_stepCount + steps;
+	restartCountdown();
+}
+
+void script::ScriptEngine::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	m_deadline = deadline;
+}
+
+void script::ScriptEngine::cancel()
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	updateStepCount();
+	m_cancelled = true;
+	// the next step checks the limits (step() tests m_cancelled in case a running step overwrites the countdown)
+	m_countdownStart = 0;
+	m_stepCountdown.store(0, std::memory_order_relaxed);
+}
+
+void script::ScriptEngine::resetLimits()
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	updateStepCount();
+	m_stepLimit = NoStepLimit;
+	m_deadline = std::chrono::steady_clock::time_point::max();
+	m_cancelled = false;
+	restartCountdown();
+}
+
+uint64_t script::ScriptEngine::getStepCount() const
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	return m_stepCount + uint64_t(std::max<int64_t>(m_countdownStart - m_stepCountdown.load(std::memory_order_relaxed), 0));
+}
+
+void script::ScriptEngine::checkLimits()
+{
+	std::lock_guard<std::mutex> g(m_limitMutex);
+	updateStepCount();
+	restartCountdown();
+
+	using Reason = ExecutionAbortedException::Reason;
+	if (m_cancelled)
+		throw ExecutionAbortedException(Reason::Cancelled);
+	if (m_stepCount > m_stepLimit)
+		throw ExecutionAbortedException(Reason::StepLimit);
+	// the clock is only read if a deadline was set
+	if (m_deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= m_deadline)
+		throw ExecutionAbortedException(Reason::Deadline);
+}
+
+void script::ScriptEngine::updateStepCount()
+{
+	// other threads may have restarted the countdown in the meantime
+	const auto countdown = m_stepCountdown.load(std::memory_order_relaxed);
+	m_stepCount += uint64_t(std::max<int64_t>(m_countdownStart - countdown, 0));
+	m_countdownStart = countdown;
+}
+
+void script::ScriptEngine::restartCountdown()
+{
+	// the step after the last allowed step checks the limits
+	const auto allowed = m_stepLimit - std::min(m_stepCount, m_stepLimit);
+	m_countdownStart = allowed < uint64_t(StepCheckInterval) ? int64_t(allowed) + 1 : StepCheckInterval;
+	// a cancelled engine fails at every step
+	if (m_cancelled)
+		m_countdownStart = 1;
+	m_stepCountdown.store(m_countdownStart, std::memory_order_relaxed);
 }
 
 script::ScriptObjectPtr script::ScriptEngine::getObject(const std::string& object) const
 {
-	const auto it = m_objects.find(object);
-	if (it == m_objects.end()) return nullptr;
+	{
+		const auto& shard = getShard(object);
+		const auto lock = readLock(shard);
+		const auto it = shard.objects.find(object);
+		// nullptr => the prototype variable was removed
+		if (it != shard.objects.end()) return it->second;
+	}
 
-	return it->second;
+	return copyPrototypeObject(object);
 }
 
 void script::ScriptEngine::setObject(const std::string& name, const ScriptObjectPtr& object)
 {
+	throwIfFrozen("setObject");
+
+	// the previous object is released after the lock (its destructor may use the engine)
+	ScriptObjectPtr previous;
+	auto& shard = getShard(name);
 	if(!object)
 	{
-		m_objects.erase(name);
+		const bool hide = hasPrototypeObject(name);
+		const auto lock = writeLock(shard);
+		if (hide)
+		{
+			previous = move(shard.objects[name]);
+			return;
+		}
+		const auto it = shard.objects.find(name);
+		if (it == shard.objects.end()) return;
+		previous = move(it->second);
+		shard.objects.erase(it);
 		return;
 	}
 
@@ -88,36 +342,109 @@ void script::ScriptEngine::setObject(const std::string& name, const ScriptObject
 	if (!islower(static_cast<unsigned char>(name[0])))
 		throw std::runtime_error("ScriptEngine::setObject object name must start with a lowercase letter");
 
-	m_objects[name] = object;
+	const auto lock = writeLock(shard);
+	auto& slot = shard.objects[name];
+	previous = move(slot);
+	slot = object;
 }
 
 void script::ScriptEngine::removeObjectVariables(const ScriptObjectPtr& object)
 {
-	auto it = m_objects.begin();
-	while (it != m_objects.end())
+	throwIfFrozen("removeObjectVariables");
+	if (!object) return;
+
+	for (auto& shard : m_shards)
 	{
-		if(it->second.get() == object.get())
-			it = m_objects.erase(it);
-		else
-			++it;
+		const auto lock = writeLock(shard);
+		auto it = shard.objects.begin();
+		while (it != shard.objects.end())
+		{
+			if (it->second.get() != object.get())
+				++it;
+			else if (hasPrototypeObject(it->first))
+				(it++)->second = nullptr;
+			else
+				it = shard.objects.erase(it);
+		}
+	}
+
+	// prototype variables that were not accessed yet (objects that can not be cloned are shared)
+	if (!m_prototypeObjects) return;
+	for (const auto& v : *m_prototypeObjects)
+	{
+		if (v.second.get() != object.get()) continue;
+		auto& shard = getShard(v.first);
+		const auto lock = writeLock(shard);
+		shard.objects.emplace(v.first, nullptr);
 	}
 }
 
 void script::ScriptEngine::clearObjects()
 {
-	m_objects.clear();
+	throwIfFrozen("clearObjects");
+
+	for (auto& shard : m_shards)
+	{
+		// release the objects after the lock
+		ObjectMap objects;
+		{
+			const auto lock = writeLock(shard);
+			objects.swap(shard.objects);
+			// hide the prototype variables
+			if (m_prototypeObjects)
+				for (const auto& v : *m_prototypeObjects)
+					if (&getShard(v.first) == &shard)
+						shard.objects.emplace(v.first, nullptr);
+		}
+	}
+}
+
+script::ScriptEngine::ObjectMap script::ScriptEngine::getObjects() const
+{
+	ObjectMap res;
+	for (const auto& shard : m_shards)
+	{
+		const auto lock = readLock(shard);
+		res.insert(shard.objects.begin(), shard.objects.end());
+	}
+
+	if (m_prototypeObjects)
+		for (const auto& v : *m_prototypeObjects)
+			if (res.find(v.first) == res.end())
+				res[v.first] = getObject(v.first);
+
+	// remove the hidden prototype variables
+	for (auto it = res.begin(); it != res.end();)
+	{
+		if (it->second) ++it;
+		else it = res.erase(it);
+	}
+	return res;
+}
+
+std::shared_ptr<const script::ScriptEngine::ObjectMap> script::ScriptEngine::getStaticObjects() const
+{
+	return loadSnapshot(m_staticObjects);
+}
+
+std::shared_ptr<const script::ScriptEngine::FunctionMap> script::ScriptEngine::getStaticFunctions() const
+{
+	return loadSnapshot(m_staticFunctions);
 }
 
 script::ScriptObjectPtr script::ScriptEngine::getStaticObject(const std::string& object) const
 {
-	const auto it = m_staticObjects.find(object);
-	if (it == m_staticObjects.end()) return nullptr;
+	const auto objects = loadSnapshot(m_staticObjects);
+	const auto it = objects->find(object);
+	if (it == objects->end()) return nullptr;
 
 	return it->second;
 }
 
 void script::ScriptEngine::setStaticObject(const std::string& name, const ScriptObjectPtr& object, bool mayOverwrite)
 {
+	throwIfFrozen("setStaticObject");
+
 	if (name.empty())
 		throw std::runtime_error("ScriptEngine::setStaticObject object name was empty");
 
@@ -127,14 +454,19 @@ void script::ScriptEngine::setStaticObject(const std::string& name, const Script
 	if (!object)
 		throw std::runtime_error("ScriptEngine::setStaticObject object was null");
 
-	if (!mayOverwrite && m_staticObjects.find(name) != m_staticObjects.end())
-		throw std::runtime_error("ScriptEngine::setStaticObject object \"" + name + "\" already exists");
+	updateSnapshot(m_staticObjects, [&](ObjectMap& objects)
+	{
+		if (!mayOverwrite && objects.find(name) != objects.end())
+			throw std::runtime_error("ScriptEngine::setStaticObject object \"" + name + "\" already exists");
 
-	m_staticObjects[name] = object;
+		objects[name] = object;
+	});
 }
 
 void script::ScriptEngine::setStaticFunction(const std::string& name, const ScriptObject::FunctionT& function)
 {
+	throwIfFrozen("setStaticFunction");
+
 	if (name.empty())
 		throw std::runtime_error("ScriptEngine::setStaticFunction function name was empty");
 
@@ -144,10 +476,13 @@ void script::ScriptEngine::setStaticFunction(const std::string& name, const Scri
 	if (!function)
 		throw std::runtime_error("ScriptEngine::setStaticFunction function was null");
 
-	if (m_staticFunctions.find(name) != m_staticFunctions.end())
-		throw std::runtime_error("ScriptEngine::setStaticFunction function \"" + name + "\" already exists");
+	updateSnapshot(m_staticFunctions, [&](FunctionMap& functions)
+	{
+		if (functions.find(name) != functions.end())
+			throw std::runtime_error("ScriptEngine::setStaticFunction function \"" + name + "\" already exists");
 
-	m_staticFunctions[name] = function;
+		functions[name] = function;
+	});
 }
 
 std::vector<std::string> script::ScriptEngine::getAutocomplete(const std::string& text)
@@ -176,18 +511,18 @@ std::vector<std::string> script::ScriptEngine::getAutocomplete(const std::string
 		if(info.callerToken.startsWithLowercase())
 		{
 			// variable
-			const auto it = m_objects.find(info.callerToken.getValue());
-			if (it != m_objects.end())
-				addAllFunctions(candidates, *it->second);
+			const auto obj = getObject(info.callerToken.getValue());
+			if (obj)
+				addAllFunctions(candidates, *obj);
 			else // add default functions
 				addAllFunctions(candidates, *NullObject::get());
 		}
 		else if(info.callerToken.startWithUppercase())
 		{
 			// static object
-			const auto it = m_staticObjects.find(info.callerToken.getValue());
-			if (it != m_staticObjects.end())
-				addAllFunctions(candidates, *it->second);
+			const auto obj = getStaticObject(info.callerToken.getValue());
+			if (obj)
+				addAllFunctions(candidates, *obj);
 			else // add default functions
 				addAllFunctions(candidates, *NullObject::get());
 		}
@@ -196,11 +531,11 @@ std::vector<std::string> script::ScriptEngine::getAutocomplete(const std::string
 	{
 		// no prior element => could be any object or static function
 		hasPreviousElement = false;
-		for (const auto& v : m_objects)
+		for (const auto& v : getObjects())
 			candidates.insert(v.first);
-		for (const auto& v : m_staticObjects)
+		for (const auto& v : *getStaticObjects())
 			candidates.insert(v.first);
-		for (const auto& v : m_staticFunctions)
+		for (const auto& v : *getStaticFunctions())
 			candidates.insert(v.first + "(");
 	}
 
@@ -244,6 +579,23 @@ std::vector<std::string> script::ScriptEngine::getAutocomplete(const std::string
 	return res;
 }
 
+std::runtime_error script::ScriptEngine::getError(std::string_view command, const ParseError& error)
+{
+	const auto pos = error.position;
+	// the command is only copied for the error message
+	std::string errorPosition(command);
+	if(pos == size_t(-1))
+	{
+		errorPosition += "<";
+	}
+	else
+	{
+		// include some parts before and some parts after the error
+		errorPosition.insert(pos, ">");
+	}
+	return std::runtime_error(error.what() + std::string(" at ") + errorPosition);
+}
+
 void script::ScriptEngine::addAllFunctions(std::unordered_set<std::string>& set, const ScriptObject& obj)
 {
 	for (const auto& v : obj.getFunctions())
@@ -258,8 +610,98 @@ void script::ScriptEngine::addAllFunctions(std::unordered_set<std::string>& set,
 
 script::ScriptObject::FunctionT script::ScriptEngine::getStaticFunction(const std::string& name)
 {
-	const auto it = m_staticFunctions.find(name);
-	if (it == m_staticFunctions.end()) return nullptr;
+	const auto functions = loadSnapshot(m_staticFunctions);
+	const auto it = functions->find(name);
+	if (it == functions->end()) return nullptr;
 
 	return it->second;
 }
+
+void script::ScriptEngine::throwIfFrozen(const char* function) const
+{
+	if (m_frozen)
+		throw std::runtime_error(std::string("ScriptEngine::") + function + " engine is frozen");
+}
+
+bool script::ScriptEngine::hasPrototypeObject(const std::string& name) const
+{
+	return m_prototypeObjects && m_prototypeObjects->find(name) != m_prototypeObjects->end();
+}
+
+script::ScriptObjectPtr script::ScriptEngine::copyPrototypeObject(const std::string& name) const
+{
+	if (!m_prototypeObjects) return nullptr;
+	const auto it = m_prototypeObjects->find(name);
+	if (it == m_prototypeObjects->end()) return nullptr;
+
+	ScriptObjectPtr copy;
+	{
+		std::lock_guard<std::mutex> g(m_prototypeMutex);
+		auto& clone = m_prototypeClones[it->second.get()];
+		if (!clone)
+		{
+			try
+			{
+				clone = it->second->clone();
+			}
+			catch (const ObjectNotCloneableException&)
+			{
+				clone = it->second;
+			}
+		}
+		copy = clone;
+	}
+
+	// another thread may have set the variable in the meantime
+	auto& shard = getShard(name);
+	const auto lock = writeLock(shard);
+	return shard.objects.emplace(name, move(copy)).first->second;
+}
+
+void script::ScriptEngine::beginAsync()
+{
+	std::lock_guard<std::mutex> g(m_asyncMutex);
+	++m_asyncPending;
+}
+
+void script::ScriptEngine::endAsync()
+{
+	// notify while locked: the destructor may run as soon as the mutex is released
+	std::lock_guard<std::mutex> g(m_asyncMutex);
+	if (--m_asyncPending == 0)
+		m_asyncDone.notify_all();
+}
+
+script::ScriptEngine::Shard& script::ScriptEngine::getShard(const std::string& name) const
+{
+	return m_shards[std::hash<std::string>()(name) % ShardCount];
+}
+
+std::shared_lock<std::shared_mutex> script::ScriptEngine::readLock(const Shard& shard) const
+{
+	if (isConcurrent())
+		return std::shared_lock<std::shared_mutex>(shard.mutex);
+	return std::shared_lock<std::shared_mutex>(shard.mutex, std::defer_lock);
+}
+
+std::unique_lock<std::shared_mutex> script::ScriptEngine::writeLock(Shard& shard) const
+{
+	if (isConcurrent())
+		return std::unique_lock<std::shared_mutex>(shard.mutex);
+	return std::unique_lock<std::shared_mutex>(shard.mutex, std::defer_lock);
+}
+
+template <class TMap, class TFunc>
+void script::ScriptEngine::updateSnapshot(std::atomic<std::shared_ptr<const TMap>>& snapshot, TFunc modify)
+{
+	std::lock_guard<std::mutex> g(m_staticMutex);
+	auto copy = std::make_shared<TMap>(*snapshot.load());
+	modify(*copy);
+	snapshot.store(std::shared_ptr<const TMap>(move(copy)));
+}
+
+template <class TMap>
+std::shared_ptr<const TMap> script::ScriptEngine::loadSnapshot(const std::atomic<std::shared_ptr<const TMap>>& snapshot)
+{
+	return snapshot.load();
+}
@@ -0,0 +1,93 @@
+#include "../../include/script/ScriptExecutor.h"
+#include "../../include/script/ScriptEngine.h"
+#include <algorithm>
+
+script::ScriptExecutor::ScriptExecutor(size_t threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (size_t i = 0; i < threadCount; ++i)
+		m_workers.push_back(std::make_unique<Worker>());
+	for (auto& w : m_workers)
+		w->thread = std::thread(&ScriptExecutor::work, std::ref(*w));
+}
+
+script::ScriptExecutor::~ScriptExecutor()
+{
+	for (auto& w : m_workers)
+	{
+		{
+			std::lock_guard<std::mutex> g(w->mutex);
+			w->stop = true;
+		}
+		w->wake.notify_one();
+	}
+	for (auto& w : m_workers)
+		w->thread.join();
+}
+
+std::future<script::ScriptObjectPtr> script::ScriptExecutor::submit(ScriptEngine& engine, std::string command)
+{
+	Task task;
+	task.engine = &engine;
+	task.command = move(command);
+	auto res = task.result.get_future();
+
+	engine.beginAsync();
+	auto& worker = *m_workers[engine.getId() % m_workers.size()];
+	worker.queue.push(std::move(task));
+	// only the first task of a batch wakes the worker
+	if (worker.pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+	{
+		std::lock_guard<std::mutex> g(worker.mutex);
+		worker.wake.notify_one();
+	}
+	return res;
+}
+
+size_t script::ScriptExecutor::getThreadCount() const
+{
+	return m_workers.size();
+}
+
+script::ScriptExecutor& script::ScriptExecutor::getDefault()
+{
+	static ScriptExecutor executor;
+	return executor;
+}
+
+void script::ScriptExecutor::work(Worker& worker)
+{
+	Task task;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(worker.mutex);
+			worker.wake.wait(lock, [&worker]() { return worker.stop || worker.pending != 0; });
+			if (worker.stop && worker.pending == 0)
+				return;
+		}
+
+		// take all tasks that were submitted so far with a single wake up
+		const size_t count = worker.pending.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; ++i)
+		{
+			// the producer may not have linked its task yet
+			while (!worker.queue.pop(task))
+				std::this_thread::yield();
+
+			try
+			{
+				task.result.set_value(task.engine->execute(task.command));
+			}
+			catch (...)
+			{
+				task.result.set_exception(std::current_exception());
+			}
+			task.result = std::promise<ScriptObjectPtr>();
+			task.engine->endAsync();
+		}
+		worker.pending.fetch_sub(count, std::memory_order_acq_rel);
+	}
+}
@@ -0,0 +1,401 @@
+#include "../../include/script/ScriptImage.h"
+#include "../../include/script/StatementReader.h"
+#include "../../include/script/Tokenizer.h"
+#include "../../include/script/tokens/L2ArgumentListToken.h"
+#include "../../include/script/tokens/L2FunctionToken.h"
+#include "../../include/script/tokens/L2IdentifierAssignToken.h"
+#include "../../include/script/tokens/L2IdentifierToken.h"
+#include "../../include/script/tokens/L2StaticIdentifierToken.h"
+#include "../../include/script/tokens/L2StaticFunctionToken.h"
+#include "../../include/script/tokens/L2OperatorToken.h"
+#include "../../include/script/tokens/L2PropertyGetterToken.h"
+#include "../../include/script/tokens/L2PropertySetterToken.h"
+#include "../../include/script/tokens/L2StringToken.h"
+#include "../../include/script/tokens/L2PrimitiveValueToken.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	const char Magic[4] = { 'C', 'S', 'I', 'M' };
+
+	uint32_t toIndex(size_t value)
+	{
+		if (value >= script::image::None)
+			throw std::runtime_error("script image is too large");
+		return uint32_t(value);
+	}
+
+	template<class T>
+	void append(std::vector<char>& buffer, const T& value)
+	{
+		const auto data = reinterpret_cast<const char*>(&value);
+		buffer.insert(buffer.end(), data, data + sizeof(T));
+	}
+
+	// start sections at 4 byte boundaries
+	uint32_t align(std::vector<char>& buffer)
+	{
+		buffer.resize((buffer.size() + 3) / 4 * 4);
+		return toIndex(buffer.size());
+	}
+}
+
+uint32_t script::ScriptImageWriter::add(const L2Token* token)
+{
+	if (token == nullptr) return image::None;
+	return token->write(*this);
+}
+
+uint32_t script::ScriptImageWriter::addNode(image::NodeType type, size_t position, uint32_t a, uint32_t b, uint32_t c,
+	uint32_t d, bool clone)
+{
+	image::Node node;
+	node.type = type;
+	node.clone = clone ? 1 : 0;
+	node.reserved = 0;
+	// positions of the end of the command are size_t(-1)
+	node.position = position == size_t(-1) ? image::None : toIndex(position);
+	node.a = a;
+	node.b = b;
+	node.c = c;
+	node.d = d;
+	m_nodes.push_back(node);
+	return toIndex(m_nodes.size() - 1);
+}
+
+uint32_t script::ScriptImageWriter::addString(std::string_view value)
+{
+	const auto res = m_stringIndices.emplace(std::string(value), toIndex(m_strings.size()));
+	if (res.second)
+		m_strings.push_back(res.first->first);
+	return res.first->second;
+}
+
+uint32_t script::ScriptImageWriter::addList(const std::vector<uint32_t>& values)
+{
+	const auto res = toIndex(m_lists.size());
+	m_lists.insert(m_lists.end(), values.begin(), values.end());
+	return res;
+}
+
+void script::ScriptImageWriter::addStatement(const L2Token* token, size_t line, std::string_view text)
+{
+	Statement s;
+	s.node = add(token);
+	s.line = toIndex(line);
+	s.text = addString(text);
+	m_statements.push_back(s);
+}
+
+void script::ScriptImageWriter::setStatics(const ScriptEngine& engine)
+{
+	m_statics.clear();
+	for (const auto& name : ScriptImage::getStaticNames(engine))
+		m_statics.push_back(addString(name));
+}
+
+void script::ScriptImageWriter::save(const std::string& filename) const
+{
+	std::vector<char> buffer(sizeof(image::Header));
+	image::Header header;
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = ScriptImage::Version;
+
+	// string table: (offset, length) pairs followed by the characters
+	header.stringCount = toIndex(m_strings.size());
+	header.stringOffset = align(buffer);
+	auto charOffset = toIndex(buffer.size() + m_strings.size() * 2 * sizeof(uint32_t));
+	for (const auto& s : m_strings)
+	{
+		append(buffer, charOffset);
+		append(buffer, toIndex(s.size()));
+		charOffset = toIndex(size_t(charOffset) + s.size());
+	}
+	for (const auto& s : m_strings)
+		buffer.insert(buffer.end(), s.begin(), s.end());
+
+	header.nodeCount = toIndex(m_nodes.size());
+	header.nodeOffset = align(buffer);
+	for (const auto& n : m_nodes)
+		append(buffer, n);
+
+	header.listCount = toIndex(m_lists.size());
+	header.listOffset = align(buffer);
+	for (const auto& v : m_lists)
+		append(buffer, v);
+
+	header.statementCount = toIndex(m_statements.size());
+	header.statementOffset = align(buffer);
+	for (const auto& s : m_statements)
+		append(buffer, s);
+
+	header.staticCount = toIndex(m_statics.size());
+	header.staticOffset = align(buffer);
+	for (const auto& v : m_statics)
+		append(buffer, v);
+
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	std::ofstream file(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		throw std::runtime_error("could not open file " + filename);
+	file.write(buffer.data(), buffer.size());
+}
+
+void script::ScriptImage::compileFile(const ScriptEngine& engine, const std::string& scriptFile, const std::string& imageFile)
+{
+	const MappedFile file(scriptFile);
+	StatementReader reader(file.getData());
+	std::vector<StatementReader::Statement> statements;
+	// the tokens only need a string table for the literals
+	StringTable strings;
+
+	ScriptImageWriter writer;
+	writer.setStatics(engine);
+	while (reader.read(statements, 4096))
+	{
+		for (const auto& s : statements)
+		{
+			std::unique_ptr<L2Token> token;
+			try
+			{
+				if (!s.getCommand().empty())
+					token = Tokenizer::getExecutable(s.getCommand(), &strings);
+			}
+			catch (const ParseError& e)
+			{
+				throw std::runtime_error(scriptFile + " line " + std::to_string(s.line) + ": " + e.what());
+			}
+			writer.addStatement(token.get(), s.line, s.getCommand());
+		}
+	}
+
+	if (reader.hasRemainder())
+		throw std::runtime_error(scriptFile + " missing ; at the end of the file");
+
+	writer.save(imageFile);
+}
+
+script::ScriptImage::ScriptImage(const std::string& filename, const ScriptEngine& engine)
+	:
+m_filename(filename),
+m_file(filename)
+{
+	if (m_file.getData().size() < sizeof(image::Header))
+		throw std::runtime_error(filename + " is not a script image");
+	m_header = read<image::Header>(0);
+	if (std::memcmp(m_header.magic, Magic, sizeof(Magic)) != 0)
+		throw std::runtime_error(filename + " is not a script image");
+	if (m_header.version != Version)
+		throw std::runtime_error(filename + " has image version " + std::to_string(m_header.version) +
+			" but the engine requires version " + std::to_string(Version));
+
+	verify();
+	verifyStatics(engine);
+}
+
+size_t script::ScriptImage::getStatementCount() const
+{
+	return m_header.statementCount;
+}
+
+size_t script::ScriptImage::getLine(size_t statement) const
+{
+	return read<uint32_t>(m_header.statementOffset + statement * 3 * sizeof(uint32_t) + sizeof(uint32_t));
+}
+
+script::ScriptEngine::CompiledCommand script::ScriptImage::getCommand(size_t statement, ScriptEngine& engine) const
+{
+	const auto offset = m_header.statementOffset + statement * 3 * sizeof(uint32_t);
+	ScriptEngine::CompiledCommand res;
+	res.text = getString(read<uint32_t>(offset + 2 * sizeof(uint32_t)));
+	const auto node = read<uint32_t>(offset);
+	if (node != image::None)
+		res.token = getToken(node, engine.getStringTable());
+	return res;
+}
+
+void script::ScriptImage::verify() const
+{
+	const auto invalid = [this]() { return std::runtime_error(m_filename + " is not a valid script image"); };
+	const auto size = m_file.getData().size();
+	const auto fits = [size](size_t offset, size_t count, size_t elementSize)
+	{
+		return offset <= size && count <= (size - offset) / elementSize;
+	};
+
+	if (!fits(m_header.stringOffset, m_header.stringCount, 2 * sizeof(uint32_t)) ||
+		!fits(m_header.nodeOffset, m_header.nodeCount, sizeof(image::Node)) ||
+		!fits(m_header.listOffset, m_header.listCount, sizeof(uint32_t)) ||
+		!fits(m_header.statementOffset, m_header.statementCount, 3 * sizeof(uint32_t)) ||
+		!fits(m_header.staticOffset, m_header.staticCount, sizeof(uint32_t)))
+		throw invalid();
+
+	for (uint32_t i = 0; i < m_header.stringCount; ++i)
+	{
+		const auto offset = read<uint32_t>(m_header.stringOffset + i * 2 * sizeof(uint32_t));
+		const auto length = read<uint32_t>(m_header.stringOffset + i * 2 * sizeof(uint32_t) + sizeof(uint32_t));
+		if (!fits(offset, length, 1))
+			throw invalid();
+	}
+
+	const auto isString = [this](uint32_t index) { return index < m_header.stringCount; };
+	// every node has at most one parent (or statement) => the tokens are a tree and not larger than the image
+	std::vector<bool> referenced(m_header.nodeCount, false);
+	const auto reference = [&referenced](uint32_t index)
+	{
+		if (referenced[index]) return false;
+		referenced[index] = true;
+		return true;
+	};
+	for (uint32_t i = 0; i < m_header.nodeCount; ++i)
+	{
+		const auto n = getNode(i);
+		// children were written before their parent => no cycles
+		const auto isChild = [i, &reference](uint32_t index) { return index < i && reference(index); };
+		bool valid;
+		switch (n.type)
+		{
+		case image::NodeType::ArgumentList:
+			valid = n.a <= m_header.listCount && n.b <= m_header.listCount - n.a;
+			for (uint32_t j = 0; valid && j < n.b; ++j)
+				valid = isChild(read<uint32_t>(m_header.listOffset + (size_t(n.a) + j) * sizeof(uint32_t)));
+			break;
+		case image::NodeType::Function: valid = isChild(n.a) && isString(n.b) && isChild(n.c); break;
+		case image::NodeType::IdentifierAssign: valid = isString(n.a) && isChild(n.b); break;
+		case image::NodeType::Identifier:
+		case image::NodeType::StaticIdentifier:
+		case image::NodeType::String: valid = isString(n.a); break;
+		case image::NodeType::StaticFunction: valid = isString(n.a) && isChild(n.b); break;
+		case image::NodeType::Operator:
+			valid = isChild(n.a) && (n.b == image::None || isChild(n.b)) && isString(n.c) && isString(n.d);
+			break;
+		case image::NodeType::PropertyGetter: valid = isChild(n.a) && isString(n.b); break;
+		case image::NodeType::PropertySetter: valid = isChild(n.a) && isChild(n.b) && isString(n.c); break;
+		case image::NodeType::Int:
+		case image::NodeType::Float:
+		case image::NodeType::Bool:
+		case image::NodeType::Null: valid = true; break;
+		default: valid = false;
+		}
+		if (!valid)
+			throw invalid();
+	}
+
+	for (uint32_t i = 0; i < m_header.statementCount; ++i)
+	{
+		const auto offset = m_header.statementOffset + i * 3 * sizeof(uint32_t);
+		const auto node = read<uint32_t>(offset);
+		if ((node != image::None && (node >= m_header.nodeCount || !reference(node))) || !isString(read<uint32_t>(offset + 2 * sizeof(uint32_t))))
+			throw invalid();
+	}
+
+	for (uint32_t i = 0; i < m_header.staticCount; ++i)
+		if (!isString(read<uint32_t>(m_header.staticOffset + i * sizeof(uint32_t))))
+			throw invalid();
+}
+
+void script::ScriptImage::verifyStatics(const ScriptEngine& engine) const
+{
+	std::vector<std::string_view> imageNames;
+	for (uint32_t i = 0; i < m_header.staticCount; ++i)
+		imageNames.push_back(getString(read<uint32_t>(m_header.staticOffset + i * sizeof(uint32_t))));
+	const auto engineNames = getStaticNames(engine);
+
+	// both lists are sorted => report the first difference
+	auto image = imageNames.begin();
+	auto own = engineNames.begin();
+	while (image != imageNames.end() && own != engineNames.end() && *image == *own)
+	{
+		++image;
+		++own;
+	}
+
+	if (image != imageNames.end() && (own == engineNames.end() || *image < *own))
+		throw std::runtime_error(m_filename + " was compiled for different statics: \"" + std::string(*image) + "\" is missing in the engine");
+	if (own != engineNames.end())
+		throw std::runtime_error(m_filename + " was compiled for different statics: \"" + *own + "\" is not in the image");
+}
+
+template <class T>
+T script::ScriptImage::read(size_t offset) const
+{
+	// the mapping may not be aligned for T
+	T res;
+	std::memcpy(&res, m_file.getData().data() + offset, sizeof(T));
+	return res;
+}
+
+std::string_view script::ScriptImage::getString(uint32_t index) const
+{
+	const auto offset = read<uint32_t>(m_header.stringOffset + size_t(index) * 2 * sizeof(uint32_t));
+	const auto length = read<uint32_t>(m_header.stringOffset + size_t(index) * 2 * sizeof(uint32_t) + sizeof(uint32_t));
+	return m_file.getData().substr(offset, length);
+}
+
+script::image::Node script::ScriptImage::getNode(uint32_t index) const
+{
+	return read<image::Node>(m_header.nodeOffset + size_t(index) * sizeof(image::Node));
+}
+
+std::unique_ptr<script::L2Token> script::ScriptImage::getToken(uint32_t index, StringTable& strings) const
+{
+	if (index == image::None) return nullptr;
+
+	const auto n = getNode(index);
+	const size_t position = n.position == image::None ? size_t(-1) : n.position;
+	const auto name = [this](uint32_t string) { return std::string(getString(string)); };
+	switch (n.type)
+	{
+	case image::NodeType::ArgumentList:
+	{
+		auto res = std::make_unique<L2ArgumentListToken>();
+		for (uint32_t i = 0; i < n.b; ++i)
+			res->add(getToken(read<uint32_t>(m_header.listOffset + (size_t(n.a) + i) * sizeof(uint32_t)), strings));
+		return res;
+	}
+	case image::NodeType::Function:
+		return std::make_unique<L2FunctionToken>(getToken(n.a, strings), name(n.b), position, getToken(n.c, strings));
+	case image::NodeType::IdentifierAssign:
+		return std::make_unique<L2IdentifierAssignToken>(name(n.a), getToken(n.b, strings));
+	case image::NodeType::Identifier:
+		return std::make_unique<L2IdentifierToken>(name(n.a), position);
+	case image::NodeType::StaticIdentifier:
+		return std::make_unique<L2StaticIdentifierToken>(name(n.a), position);
+	case image::NodeType::StaticFunction:
+		return std::make_unique<L2StaticFunctionToken>(name(n.a), position, getToken(n.b, strings));
+	case image::NodeType::Operator:
+		return std::make_unique<L2OperatorToken>(getToken(n.a, strings), getToken(n.b, strings), position, name(n.c), n.clone != 0, name(n.d));
+	case image::NodeType::PropertyGetter:
+		return std::make_unique<L2PropertyGetterToken>(getToken(n.a, strings), name(n.b), position);
+	case image::NodeType::PropertySetter:
+		return std::make_unique<L2PropertySetterToken>(getToken(n.a, strings), getToken(n.b, strings), name(n.c), position);
+	case image::NodeType::String:
+		return std::make_unique<L2StringToken>(strings.intern(getString(n.a)));
+	case image::NodeType::Int:
+		return std::make_unique<L2PrimitiveValueToken<int>>(int(n.a));
+	case image::NodeType::Float:
+	{
+		float value;
+		std::memcpy(&value, &n.a, sizeof(value));
+		return std::make_unique<L2PrimitiveValueToken<float>>(value);
+	}
+	case image::NodeType::Bool:
+		return std::make_unique<L2PrimitiveValueToken<bool>>(n.a != 0);
+	default:
+		return std::make_unique<L2PrimitiveValueToken<nullptr_t>>(nullptr);
+	}
+}
+
+std::vector<std::string> script::ScriptImage::getStaticNames(const ScriptEngine& engine)
+{
+	std::vector<std::string> res;
+	for (const auto& o : *engine.getStaticObjects())
+		res.push_back(o.first);
+	for (const auto& f : *engine.getStaticFunctions())
+		res.push_back(f.first + "(");
+	std::sort(res.begin(), res.end());
+	return res;
+}
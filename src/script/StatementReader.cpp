@@ -0,0 +1,87 @@
+#include "../../include/script/StatementReader.h"
+#include <cctype>
+
+script::StatementReader::StatementReader(std::string_view text)
+	:
+m_text(text)
+{}
+
+bool script::StatementReader::read(std::vector<Statement>& statements, size_t maxCount)
+{
+	statements.clear();
+	Statement s;
+	while (statements.size() < maxCount && readStatement(s))
+	{
+		statements.push_back(std::move(s));
+		s = Statement();
+	}
+	return !statements.empty();
+}
+
+bool script::StatementReader::readStatement(Statement& s)
+{
+	// start of the part of the statement that was not added to the copy
+	auto begin = std::string_view::npos;
+	bool isComment = false;
+	const auto isEmpty = [&]() { return begin == std::string_view::npos && !s.isCopy; };
+
+	for (; m_pos < m_text.size(); ++m_pos)
+	{
+		const char c = m_text[m_pos];
+		// new line
+		if (c == '\n')
+		{
+			m_line++;
+			isComment = false;
+		}
+
+		// ignore values in comments
+		if (isComment) continue;
+
+		// start the statement with the first non whitespace character
+		if (isEmpty())
+		{
+			if (isspace(static_cast<unsigned char>(c)))
+				continue;
+			// line number should be number of first character
+			s.line = m_line;
+		}
+		if (begin == std::string_view::npos)
+			begin = m_pos;
+
+		switch (c)
+		{
+		case '\\':
+			// some escape character => skip the next character
+			if (m_pos + 1 < m_text.size())
+				++m_pos;
+			continue;
+		case ';':
+			// end of statement
+			if (s.isCopy)
+				s.copy.append(m_text.substr(begin, m_pos - begin));
+			else
+				s.view = m_text.substr(begin, m_pos - begin);
+			++m_pos;
+			return true;
+		case '/':
+			// comment start => the statement can not be a view into the text
+			if (m_pos + 1 < m_text.size() && m_text[m_pos + 1] == '/')
+			{
+				if (m_pos != begin || s.isCopy)
+				{
+					s.copy.append(m_text.substr(begin, m_pos - begin));
+					s.isCopy = true;
+				}
+				begin = std::string_view::npos;
+				isComment = true;
+			}
+			continue;
+		}
+	}
+
+	// the end of the text is reached once => a later read may not clear the remainder
+	if (!isEmpty())
+		m_remainder = true;
+	return false;
+}
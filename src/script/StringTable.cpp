@@ -0,0 +1,44 @@
+#include "../../include/script/StringTable.h"
+#include <algorithm>
+
+script::StringTable::StringPtr script::StringTable::intern(std::string_view value)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const auto it = m_strings.find(value);
+	if (it != m_strings.end())
+		return it->second;
+
+	if (m_strings.size() >= m_collectSize)
+	{
+		// remove unused strings before the table grows
+		collectUnlocked();
+		m_collectSize = std::max(m_collectSize, 2 * m_strings.size());
+	}
+
+	auto payload = std::make_shared<const std::string>(value);
+	m_strings.emplace(std::string_view(*payload), payload);
+	return payload;
+}
+
+size_t script::StringTable::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_strings.size();
+}
+
+void script::StringTable::collect()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	collectUnlocked();
+}
+
+void script::StringTable::collectUnlocked()
+{
+	for (auto it = m_strings.begin(); it != m_strings.end();)
+	{
+		if (it->second.use_count() == 1)
+			it = m_strings.erase(it);
+		else
+			++it;
+	}
+}
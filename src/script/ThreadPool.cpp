@@ -0,0 +1,193 @@
+#include "../../include/script/ThreadPool.h"
+#include <algorithm>
+#include <exception>
+
+namespace
+{
+	thread_local script::ThreadPool* s_current = nullptr;
+	// queue index of the worker thread (-1 for other threads)
+	thread_local size_t s_workerIndex = size_t(-1);
+	thread_local const script::ThreadPool* s_workerPool = nullptr;
+
+	// hardware_concurrency may read from the file system => query once (engines are created per session)
+	size_t getHardwareThreads()
+	{
+		static const size_t count = std::max(1u, std::thread::hardware_concurrency());
+		return count;
+	}
+
+	struct Batch
+	{
+		std::atomic<size_t> remaining;
+		std::mutex mutex;
+		std::condition_variable done;
+		std::exception_ptr error;
+	};
+}
+
+script::ThreadPool::ThreadPool(size_t threadCount)
+	:
+m_threadCount(threadCount ? threadCount : getHardwareThreads())
+{
+	for (size_t i = 0; i < m_threadCount; ++i)
+		m_queues.push_back(std::make_unique<Queue>());
+}
+
+script::ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> g(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (auto& t : m_threads)
+		t.join();
+}
+
+size_t script::ThreadPool::getThreadCount() const
+{
+	return m_threadCount;
+}
+
+void script::ThreadPool::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+{
+	if (count == 0) return;
+	grainSize = std::max<size_t>(grainSize, 1);
+	const size_t chunks = (count + grainSize - 1) / grainSize;
+	if (chunks == 1 || m_threadCount == 1)
+	{
+		func(0, count);
+		return;
+	}
+
+	std::call_once(m_started, [this]() { start(); });
+
+	Batch batch;
+	batch.remaining = chunks;
+	auto finish = [&batch]()
+	{
+		std::lock_guard<std::mutex> g(batch.mutex);
+		if (--batch.remaining == 0)
+			batch.done.notify_all();
+	};
+
+	const size_t own = s_workerPool == this ? s_workerIndex : m_threadCount - 1;
+	m_pending += chunks;
+	for (size_t i = 0; i < chunks; ++i)
+	{
+		const size_t begin = i * grainSize;
+		const size_t end = std::min(begin + grainSize, count);
+		push((own + i) % m_queues.size(), [&func, &batch, &finish, begin, end]()
+		{
+			try
+			{
+				func(begin, end);
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> g(batch.mutex);
+				if (!batch.error)
+					batch.error = std::current_exception();
+			}
+			finish();
+		});
+	}
+	{
+		std::lock_guard<std::mutex> g(m_mutex);
+	}
+	m_wake.notify_all();
+
+	// help until all chunks are taken
+	Task task;
+	while (batch.remaining != 0 && pop(own, task))
+	{
+		--m_pending;
+		task();
+	}
+
+	std::unique_lock<std::mutex> lock(batch.mutex);
+	batch.done.wait(lock, [&batch]() { return batch.remaining == 0; });
+	if (batch.error)
+		std::rethrow_exception(batch.error);
+}
+
+script::ThreadPool* script::ThreadPool::getCurrent()
+{
+	return s_current;
+}
+
+script::ThreadPool::Scope::Scope(ThreadPool* pool)
+	:
+m_previous(s_current)
+{
+	s_current = pool;
+}
+
+script::ThreadPool::Scope::~Scope()
+{
+	s_current = m_previous;
+}
+
+void script::ThreadPool::start()
+{
+	// the calling thread is the last worker
+	for (size_t i = 0; i + 1 < m_threadCount; ++i)
+		m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+void script::ThreadPool::work(size_t index)
+{
+	s_current = this;
+	s_workerIndex = index;
+	s_workerPool = this;
+
+	Task task;
+	while (true)
+	{
+		if (pop(index, task))
+		{
+			--m_pending;
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_wake.wait(lock, [this]() { return m_stop || m_pending != 0; });
+		if (m_stop && m_pending == 0)
+			return;
+	}
+}
+
+bool script::ThreadPool::pop(size_t index, Task& task)
+{
+	{
+		auto& own = *m_queues[index];
+		std::lock_guard<std::mutex> g(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	for (size_t i = 1; i < m_queues.size(); ++i)
+	{
+		auto& other = *m_queues[(index + i) % m_queues.size()];
+		std::lock_guard<std::mutex> g(other.mutex);
+		if (!other.tasks.empty())
+		{
+			task = std::move(other.tasks.front());
+			other.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void script::ThreadPool::push(size_t index, Task task)
+{
+	auto& queue = *m_queues[index];
+	std::lock_guard<std::mutex> g(queue.mutex);
+	queue.tasks.push_back(std::move(task));
+}
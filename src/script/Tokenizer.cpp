@@ -16,19 +16,20 @@
 #include "../../include/script/tokens/L2PropertySetterToken.h"
 #include "../../include/script/tokens/L2StaticIdentifierToken.h"
 #include "../../include/script/tokens/L2PrimitiveValueToken.h"
+#include "../../include/script/tokens/L2StringToken.h"
 #include "../../include/script/objects/FloatObject.h"
 #include "../include/script/tokens/ttype.h"
 #include <array>
 #include <stack>
 
-std::unique_ptr<script::L2Token> script::Tokenizer::getExecutable(const std::string& command)
+std::unique_ptr<script::L2Token> script::Tokenizer::getExecutable(std::string_view command, StringTable* strings)
 {
 	std::vector<L1Token> tokens = getL1Tokens(command);
 	verifyBrackets(tokens);
 	applyL1Rules(tokens);
 
 	auto start = tokens.cbegin();
-	auto res = getL2Tokens(start, tokens.cend(), false, OpReturnMode::End);
+	auto res = getL2Tokens(start, tokens.cend(), false, OpReturnMode::End, strings);
 	if (start != tokens.cend())
 		throw SyntaxError(start->getPosition(), start->getValue(), "");
 
@@ -113,7 +114,7 @@ script::Tokenizer::AutocompleteInfo script::Tokenizer::getAutocomplete(const std
 	}
 }
 
-std::vector<script::L1Token> script::Tokenizer::getL1Tokens(const std::string& command, bool throwExceptions)
+std::vector<script::L1Token> script::Tokenizer::getL1Tokens(std::string_view command, bool throwExceptions)
 {
 	std::vector<L1Token> tokens;
 	tokens.reserve(100);
@@ -301,7 +302,7 @@ void script::Tokenizer::verifyBrackets(const std::vector<L1Token>& tokens)
 }
 
 std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end,
-	bool isArgumentList, OpReturnMode mode)
+	bool isArgumentList, OpReturnMode mode, StringTable* strings)
 {
 	std::unique_ptr<L2Token> curToken;
 	while (start != end)
@@ -313,7 +314,10 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 			if (curToken)
 				throw SyntaxError(start->getPosition(), start->getValue(), "");
 
-			curToken = std::make_unique<L2PrimitiveValueToken<std::string>>(start++->getValue());
+			if (strings)
+				curToken = std::make_unique<L2StringToken>(strings->intern(start++->getValue()));
+			else
+				curToken = std::make_unique<L2StringToken>(std::make_shared<const std::string>(start++->getValue()));
 			break;
 		case L1Token::Type::Float:
 			if (curToken)
@@ -359,7 +363,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				throw SyntaxError(start->getPosition(), start->getValue(), "");
 
 			auto name = start->getValue();
-			auto val = getL2Tokens(++start, end, true, OpReturnMode::End);
+			auto val = getL2Tokens(++start, end, true, OpReturnMode::End, strings);
 			return std::make_unique<L2IdentifierAssignToken>(name, move(val));
 		}
 #pragma endregion
@@ -370,16 +374,16 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 			// not supported yet... replace with identifier assign
 			throw SyntaxError(start->getPosition(), start->getValue(), "");
 		case L1Token::Type::PlusAssign: 
-			handleOperatorAssign(start, end, curToken, isArgumentList, "add", "+=");
+			handleOperatorAssign(start, end, curToken, isArgumentList, "add", "+=", strings);
 			break;
 		case L1Token::Type::MinusAssign:
-			handleOperatorAssign(start, end, curToken, isArgumentList, "subtract", "-=");
+			handleOperatorAssign(start, end, curToken, isArgumentList, "subtract", "-=", strings);
 			break;
 		case L1Token::Type::MultiplyAssign:
-			handleOperatorAssign(start, end, curToken, isArgumentList, "multiply", "*=");
+			handleOperatorAssign(start, end, curToken, isArgumentList, "multiply", "*=", strings);
 			break;
 		case L1Token::Type::DivideAssign:
-			handleOperatorAssign(start, end, curToken, isArgumentList, "divide", "/=");
+			handleOperatorAssign(start, end, curToken, isArgumentList, "divide", "/=", strings);
 			break;
 #pragma endregion
 
@@ -395,7 +399,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 
 			// read value within brackets
 			const auto pos = start->getPosition();
-			curToken = getL2Tokens(++start, end, true, OpReturnMode::End);
+			curToken = getL2Tokens(++start, end, true, OpReturnMode::End, strings);
 			// start should point to bracket end
 			if (start == end) 
 				throw SyntaxError(pos, "end of command", "missing closing bracket");
@@ -416,7 +420,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 			if (curToken)
 				throw SyntaxError(start->getPosition(), start->getValue(), "");
 			// parse arguments
-			auto args = parseArgumentList(++start, end, L1Token::Type::ArrayClosed, "array");
+			auto args = parseArgumentList(++start, end, L1Token::Type::ArrayClosed, "array", strings);
 			curToken = move(args);
 		} break;
 
@@ -434,7 +438,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				return curToken;
 
 			// add curToken with the next value
-			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::PlusMinus);
+			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::PlusMinus, strings);
 			curToken = std::make_unique<L2OperatorToken>(move(curToken), move(nextVal), pos, "add", true, "+");
 		} break;
 		case L1Token::Type::Minus:
@@ -442,7 +446,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 			{
 				// changes the sign of the next object
 				auto pos = start->getPosition();
-				auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv);
+				auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv, strings);
 				curToken = std::make_unique<L2OperatorToken>(move(nextVal), nullptr, pos, "negate", true, "-");
 			}
 			else
@@ -452,7 +456,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 					return curToken;
 
 				auto pos = start->getPosition();
-				auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::PlusMinus);
+				auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::PlusMinus, strings);
 				curToken = std::make_unique<L2OperatorToken>(move(curToken), move(nextVal), pos, "subtract", true, "-");
 			}
 			break;
@@ -463,7 +467,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				return curToken;
 			auto pos = start->getPosition();
 			// multiply with next value
-			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv);
+			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv, strings);
 			curToken = std::make_unique<L2OperatorToken>(move(curToken), move(nextVal), pos, "multiply", true, "*");
 		}break;
 		case L1Token::Type::Divide: {
@@ -473,7 +477,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				return curToken;
 			auto pos = start->getPosition();
 			// divide with next value
-			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv);
+			auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::MultDiv, strings);
 			curToken = std::make_unique<L2OperatorToken>(move(curToken), move(nextVal), pos, "divide", true, "/");
 		}break;
 #pragma endregion 
@@ -492,7 +496,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				// make function call
 				auto funcName = start->getValue();
 				// parse arguments
-				auto args = parseArgumentList(++start, end, L1Token::Type::BracketClosed, "function call");
+				auto args = parseArgumentList(++start, end, L1Token::Type::BracketClosed, "function call", strings);
 
 				// function call ended
 				curToken = std::make_unique<L2FunctionToken>(move(curToken), funcName, pos, move(args));
@@ -515,7 +519,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 
 				// make setter function
 				auto setName = start->getValue();
-				auto arg = getL2Tokens(++start, end, false, OpReturnMode::End);
+				auto arg = getL2Tokens(++start, end, false, OpReturnMode::End, strings);
 				curToken = std::make_unique<L2PropertySetterToken>(move(curToken), move(arg), move(setName), pos);
 			}
 			else throw SyntaxError(start->getPosition(), start->getValue(), "expected function call or property");
@@ -526,7 +530,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 				throw SyntaxError(start->getPosition(), start->getValue(), "");
 			auto name = start->getValue();
 			auto pos = start->getPosition();
-			auto args = parseArgumentList(++start, end, L1Token::Type::BracketClosed, "function call");
+			auto args = parseArgumentList(++start, end, L1Token::Type::BracketClosed, "function call", strings);
 
 			curToken = std::make_unique<L2StaticFunctionToken>(name, pos, move(args));
 		} break;
@@ -552,7 +556,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::getL2Tokens(std::vector<L1To
 }
 
 std::unique_ptr<script::L2Token> script::Tokenizer::parseArgumentList(
-	std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, L1Token::Type endToken, const std::string& type)
+	std::vector<L1Token>::const_iterator& start, std::vector<L1Token>::const_iterator end, L1Token::Type endToken, const std::string& type, StringTable* strings)
 {
 	auto args = std::make_unique<L2ArgumentListToken>();
 
@@ -569,7 +573,7 @@ std::unique_ptr<script::L2Token> script::Tokenizer::parseArgumentList(
 		if (start == end)
 			throw SyntaxError(-1, "end of command", type + " was not closed");
 
-		auto value = getL2Tokens(start, end, true, OpReturnMode::End);
+		auto value = getL2Tokens(start, end, true, OpReturnMode::End, strings);
 		args->add(move(value));
 
 		if (start == end)
@@ -587,13 +591,13 @@ std::unique_ptr<script::L2Token> script::Tokenizer::parseArgumentList(
 
 void script::Tokenizer::handleOperatorAssign(std::vector<L1Token>::const_iterator& start,
 	std::vector<L1Token>::const_iterator end, std::unique_ptr<L2Token>& curToken, bool isArgumentList,
-	std::string funcName, std::string opName)
+	std::string funcName, std::string opName, StringTable* strings)
 {
 	if (!curToken)
 		throw SyntaxError(start->getPosition(), start->getValue(), "operand on left side missing");
 
 	auto pos = start->getPosition();
-	auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::End);
+	auto nextVal = getL2Tokens(++start, end, isArgumentList, OpReturnMode::End, strings);
 	curToken = std::make_unique<L2OperatorToken>(move(curToken), move(nextVal), pos, move(funcName), false, move(opName));
 }
 
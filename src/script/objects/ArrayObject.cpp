@@ -1,7 +1,103 @@
 #include "../../../include/script/objects/ArrayObject.h"
 #include "../../../include/script/Util.h"
+#include "../../../include/script/OutputSink.h"
+#include "../../../include/script/RecursionGuard.h"
+#include "../../../include/script/Hash.h"
+#include "../../../include/script/objects/IntObject.h"
+#include "../../../include/script/objects/FloatObject.h"
+#include "../../../include/script/objects/StringObject.h"
+#include "../../../include/script/objects/BoolObject.h"
+#include "../../../include/script/ThreadPool.h"
 #include <cassert>
-#include <mutex>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <typeindex>
+#include <unordered_set>
+
+namespace
+{
+	/// \brief stable sort that sorts chunks of large ranges on separate threads and merges them afterwards
+	template<class T, class TLess>
+	void stableSort(std::vector<T>& values, TLess less)
+	{
+		// the chunks run on the pool of the engine => no additional threads inside executor or pool workers
+		const auto pool = script::ThreadPool::getCurrent();
+		if (values.size() < script::ArrayObject::ParallelSortThreshold || pool == nullptr || pool->getThreadCount() == 1)
+		{
+			std::stable_sort(values.begin(), values.end(), less);
+			return;
+		}
+
+		const size_t chunks = std::min<size_t>(pool->getThreadCount(), 16);
+		std::vector<size_t> bounds(chunks + 1);
+		for (size_t i = 0; i <= chunks; ++i)
+			bounds[i] = values.size() * i / chunks;
+
+		pool->parallelFor(chunks, 1, [&values, &bounds, &less](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i != end; ++i)
+				std::stable_sort(values.begin() + bounds[i], values.begin() + bounds[i + 1], less);
+		});
+
+		// merge neighbouring chunks (the left chunk wins ties => stable)
+		for (size_t width = 1; width < chunks; width *= 2)
+			for (size_t i = 0; i + width < chunks; i += 2 * width)
+				std::inplace_merge(values.begin() + bounds[i], values.begin() + bounds[i + width],
+					values.begin() + bounds[std::min(i + 2 * width, chunks)], less);
+	}
+
+	/// \brief collects (key, index) pairs if all objects are TObject
+	template<class TObject, class TKey, class TGet>
+	bool getKeys(const std::vector<script::ScriptObjectPtr>& objects, std::vector<std::pair<TKey, size_t>>& keys, TGet get)
+	{
+		keys.reserve(objects.size());
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			auto obj = dynamic_cast<TObject*>(objects[i].get());
+			if (obj == nullptr) return false;
+			keys.emplace_back(get(*obj), i);
+		}
+		return true;
+	}
+
+	/// \brief sorts the (key, index) pairs and returns the indices
+	template<class TKey, class TLess>
+	std::vector<size_t> getOrder(std::vector<std::pair<TKey, size_t>>& keys, TLess less)
+	{
+		stableSort(keys, [less](const std::pair<TKey, size_t>& a, const std::pair<TKey, size_t>& b)
+		{
+			return less(a.first, b.first);
+		});
+		std::vector<size_t> order;
+		order.reserve(keys.size());
+		for (const auto& k : keys)
+			order.push_back(k.second);
+		return order;
+	}
+
+	// NaN is greater than all numbers
+	bool lessNumber(double a, double b)
+	{
+		if (std::isnan(a)) return false;
+		return std::isnan(b) || a < b;
+	}
+
+	bool getNumber(const script::ScriptObjectPtr& obj, double& result)
+	{
+		if (auto i = dynamic_cast<script::IntObject*>(obj.get()))
+		{
+			result = i->getValue();
+			return true;
+		}
+		if (auto f = dynamic_cast<script::FloatObject*>(obj.get()))
+		{
+			result = f->getValue();
+			return true;
+		}
+		return false;
+	}
+}
 
 script::ArrayObject::ArrayObject()
 	:
@@ -10,7 +106,8 @@ ArrayObject(std::vector<ScriptObjectPtr>{})
 
 script::ArrayObject::ArrayObject(std::vector<ScriptObjectPtr> values)
 	:
-	m_values(std::move(values))
+	m_values(std::make_shared<std::vector<ScriptObjectPtr>>(std::move(values))),
+	m_count(m_values->size())
 {
 	addFunction("get", Util::makeFunction(this, &ArrayObject::get, "ArrayObject::get(int index)"));
 	addFunction("set", Util::makeFunction(this, &ArrayObject::set, "ArrayObject::set(int index, object)"));
@@ -28,43 +125,96 @@ script::ArrayObject::ArrayObject(std::vector<ScriptObjectPtr> values)
 		Util::makeFunction(this, static_cast<std::shared_ptr<ArrayObject>(ArrayObject::*)(int, int)>(&ArrayObject::slice), "ArrayObject ArrayObject::slice(int from, int count)"),
 		Util::makeFunction(this, static_cast<std::shared_ptr<ArrayObject>(ArrayObject::*)(int)>(&ArrayObject::slice), "ArrayObject ArrayObject::slice(int from)")
 	}));
+	addFunction("sort", Util::makeFunction(this, &ArrayObject::sort, "ArrayObject::sort()"));
+	addFunction("sortBy", Util::makeFunction(this, &ArrayObject::sortBy, "ArrayObject::sortBy(string property)"));
+	addFunction("indexOf", Util::makeFunction(this, &ArrayObject::indexOf, "int ArrayObject::indexOf(object)"));
+	addFunction("contains", Util::makeFunction(this, &ArrayObject::contains, "bool ArrayObject::contains(object)"));
+	addFunction("binarySearch", Util::makeFunction(this, &ArrayObject::binarySearch, "int ArrayObject::binarySearch(object)"));
+	// the remaining arguments are forwarded to the elements
+	addFunction("invokeAll", [this](const ArrayObjectPtr& args)
+	{
+		if (args->getCount() == 0)
+			throw InvalidArgumentCount("ArrayObject::invokeAll(string name, args...)", 1, 0);
+		invokeAll(Util::fromObject<std::string>(args->get(0)), args->getCount() > 1 ? args->slice(1) : std::make_shared<ArrayObject>());
+		return this->shared_from_this();
+	});
+	addFunction("mapInvoke", [this](const ArrayObjectPtr& args) -> ScriptObjectPtr
+	{
+		if (args->getCount() == 0)
+			throw InvalidArgumentCount("ArrayObject::mapInvoke(string name, args...)", 1, 0);
+		return mapInvoke(Util::fromObject<std::string>(args->get(0)), args->getCount() > 1 ? args->slice(1) : std::make_shared<ArrayObject>());
+	});
+	addFunction("parallelInvokeAll", [this](const ArrayObjectPtr& args)
+	{
+		if (args->getCount() == 0)
+			throw InvalidArgumentCount("ArrayObject::parallelInvokeAll(string name, args...)", 1, 0);
+		parallelInvokeAll(Util::fromObject<std::string>(args->get(0)), args->getCount() > 1 ? args->slice(1) : std::make_shared<ArrayObject>());
+		return this->shared_from_this();
+	});
+	addFunction("parallelMap", [this](const ArrayObjectPtr& args) -> ScriptObjectPtr
+	{
+		if (args->getCount() == 0)
+			throw InvalidArgumentCount("ArrayObject::parallelMap(string name, args...)", 1, 0);
+		return parallelMap(Util::fromObject<std::string>(args->get(0)), args->getCount() > 1 ? args->slice(1) : std::make_shared<ArrayObject>());
+	});
+	addFunction("parallelReduce", Util::fromLambda([this](const std::string& name)
+	{
+		return parallelReduce(name);
+	}, "object ArrayObject::parallelReduce(string name)"));
 }
 
 std::string script::ArrayObject::toString() const
 {
-	if (m_values.empty())
-		return "[]";
+	StringSink sink;
+	writeTo(sink);
+	return sink.release();
+}
 
-	if (m_toStringMutex.locked())
-		return "[...]";
+void script::ArrayObject::writeTo(OutputSink& sink) const
+{
+	if (m_count == 0)
+	{
+		sink.write("[]");
+		return;
+	}
 
-	std::lock_guard<BoolMutex> g(m_toStringMutex);
+	const RecursionGuard guard(this, RecursionGuard::Operation::ToString);
+	if (guard.isRecursive())
+	{
+		sink.write("[...]");
+		return;
+	}
 
-	std::string res = "[";
-	for (size_t i = 0; i < m_values.size() - 1; ++i)
+	sink.write('[');
+	for (auto it = begin(), first = begin(), last = end(); it != last; ++it)
 	{
-		res += m_values[i]->toString();
-		res += ", ";
+		if (it != first)
+			sink.write(", ");
+		if (sink.isFull())
+		{
+			sink.setTruncated();
+			return;
+		}
+		(*it)->writeTo(sink);
 	}
-	res += m_values.back()->toString();
-	res += "]";
-	return res;
+	sink.write(']');
 }
 
 const script::ScriptObjectPtr& script::ArrayObject::get(int index) const
 {
-	if (index >= int(m_values.size()) || index < 0)
+	if (index >= int(m_count) || index < 0)
 		throw std::out_of_range("ArrayObject::get index out of range: " + std::to_string(index));
 
-	return m_values[index];
+	return (*m_values)[m_offset + index];
 }
 
 void script::ArrayObject::set(int index, ScriptObjectPtr object)
 {
-	if (index >= int(m_values.size()) || index < 0)
+	if (index >= int(m_count) || index < 0)
 		throw std::out_of_range("ArrayObject::set index out of range: " + std::to_string(index));
 
-	m_values[index] = move(object);
+	detach();
+	(*m_values)[index] = move(object);
 }
 
 void script::ArrayObject::add(ScriptObjectPtr object)
@@ -73,44 +223,71 @@ void script::ArrayObject::add(ScriptObjectPtr object)
 	//if (!object)
 	//	throw std::runtime_error("ArrayObject::add object not set to a reference (nullptr)");
 
-	m_values.push_back(std::move(object));
+	detach();
+	m_values->push_back(std::move(object));
+	++m_count;
 }
 
 void script::ArrayObject::remove(int index)
 {
-	if (index >= int(m_values.size()) || index < 0)
+	if (index >= int(m_count) || index < 0)
 		throw std::out_of_range("ArrayObject::remove index out of range: " + std::to_string(index));
 
-	m_values.erase(m_values.begin() + index);
+	detach();
+	m_values->erase(m_values->begin() + index);
+	--m_count;
 }
 
 void script::ArrayObject::clear()
 {
-	m_values.clear();
+	// don't touch the shared storage
+	m_values = std::make_shared<std::vector<ScriptObjectPtr>>();
+	m_offset = 0;
+	m_count = 0;
 }
 
 void script::ArrayObject::addAll(const ScriptPtr<ArrayObject>& other)
 {
+	if (m_count == 0)
+	{
+		// share the storage of the other array
+		m_values = other->m_values;
+		m_offset = other->m_offset;
+		m_count = other->m_count;
+		return;
+	}
+
+	if (m_values == other->m_values)
+	{
+		// other shares the storage (or is this array) => copy the range first
+		const std::vector<ScriptObjectPtr> range(other->begin(), other->end());
+		detach();
+		m_values->insert(m_values->end(), range.begin(), range.end());
+		m_count += range.size();
+		return;
+	}
+
 	// add all elements
-	const int count = other->getCount();
-	for (int i = 0; i < count; ++i)
-		m_values.push_back(other->get(i));
+	detach();
+	m_values->insert(m_values->end(), other->begin(), other->end());
+	m_count += other->m_count;
 }
 
 std::shared_ptr<script::ArrayObject> script::ArrayObject::slice(int from, int count)
 {
-	if (from >= int(m_values.size()) || from < 0)
+	if (from >= int(m_count) || from < 0)
 		throw std::out_of_range("ArrayObject::slice from out of range");
 	if (count < 0)
 		throw std::runtime_error("ArrayObject::slice getCount may not be smaller than zero");
-	if (from + count > int(m_values.size()))
+	if (from + count > int(m_count))
 		throw std::out_of_range("ArrayObject::slice getCount exceeds array");
 
-	std::vector<ScriptObjectPtr> res;
-	for (int i = from; i < from + count; ++i)
-		res.push_back(m_values[i]);
-
-	return std::make_shared<ArrayObject>(res);
+	// reference the same storage
+	auto res = std::make_shared<ArrayObject>();
+	res->m_values = m_values;
+	res->m_offset = m_offset + size_t(from);
+	res->m_count = size_t(count);
+	return res;
 }
 
 std::shared_ptr<script::ArrayObject> script::ArrayObject::slice(int from)
@@ -118,40 +295,357 @@ std::shared_ptr<script::ArrayObject> script::ArrayObject::slice(int from)
 	return slice(from, getCount() - from);
 }
 
+void script::ArrayObject::sort()
+{
+	detach();
+	// the elements are their own keys
+	sortByKeys(*m_values);
+}
+
+void script::ArrayObject::sortBy(const std::string& property)
+{
+	std::vector<ScriptObjectPtr> keys;
+	keys.reserve(m_count);
+	const auto noArgs = Util::makeArray();
+	for (auto it = begin(), last = end(); it != last; ++it)
+		keys.push_back((*it)->invoke("get" + property, noArgs));
+
+	detach();
+	sortByKeys(keys);
+}
+
+int script::ArrayObject::indexOf(const ScriptObjectPtr& object) const
+{
+	const auto first = begin(), last = end();
+
+	// compare the plain values if possible
+	if (auto i = dynamic_cast<IntObject*>(object.get()))
+	{
+		const int value = i->getValue();
+		for (auto it = first; it != last; ++it)
+			if (auto e = dynamic_cast<IntObject*>(it->get()); e && e->getValue() == value)
+				return int(it - first);
+		return -1;
+	}
+	if (auto s = dynamic_cast<StringObject*>(object.get()))
+	{
+		const auto value = s->getView();
+		for (auto it = first; it != last; ++it)
+			if (auto e = dynamic_cast<StringObject*>(it->get()); e && e->getView() == value)
+				return int(it - first);
+		return -1;
+	}
+
+	for (auto it = first; it != last; ++it)
+		if (it->get() == object.get() || (*it)->equals(object))
+			return int(it - first);
+	return -1;
+}
+
+bool script::ArrayObject::contains(const ScriptObjectPtr& object) const
+{
+	return indexOf(object) >= 0;
+}
+
+int script::ArrayObject::binarySearch(const ScriptObjectPtr& object) const
+{
+	int low = 0;
+	int high = int(m_count);
+	while (low < high)
+	{
+		const int mid = low + (high - low) / 2;
+		const int res = compare(get(mid), object);
+		if (res == 0)
+			return mid;
+		if (res < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return -low - 1;
+}
+
+template<class TFunc>
+void script::ArrayObject::forEachFunction(const std::string& name, const char* caller, TFunc func) const
+{
+	// look up the function once per element type before anything is invoked
+	std::unordered_set<std::type_index> verified;
+	for (auto it = begin(), last = end(); it != last; ++it)
+		if (verified.insert(typeid(**it)).second && !(*it)->findFunction(name))
+			throw InvalidFunctionName(caller, name);
+
+	// the elements keep their functions alive => hold a reference in case the array is modified by a call
+	const auto values = m_values;
+	for (auto it = values->cbegin() + m_offset, last = it + m_count; it != last; ++it)
+	{
+		// instances of the same type may still have removed the function
+		const auto f = (*it)->findFunction(name);
+		if (f == nullptr)
+			throw InvalidFunctionName(caller, name);
+		func(*it, *f);
+	}
+}
+
+void script::ArrayObject::invokeAll(const std::string& name, const ArrayObjectPtr& args) const
+{
+	forEachFunction(name, "ArrayObject::invokeAll", [&args](const ScriptObjectPtr&, const FunctionT& func)
+	{
+		func(args);
+	});
+}
+
+script::ArrayObjectPtr script::ArrayObject::mapInvoke(const std::string& name, const ArrayObjectPtr& args) const
+{
+	std::vector<ScriptObjectPtr> res;
+	res.reserve(m_count);
+	forEachFunction(name, "ArrayObject::mapInvoke", [&args, &res](const ScriptObjectPtr&, const FunctionT& func)
+	{
+		res.push_back(func(args));
+	});
+	return std::make_shared<ArrayObject>(move(res));
+}
+
+void script::ArrayObject::parallelInvokeAll(const std::string& name, const ArrayObjectPtr& args, ThreadPool* pool) const
+{
+	const auto parallelPool = getParallelPool(name, "ArrayObject::parallelInvokeAll", args.get(), pool);
+	if (parallelPool == nullptr)
+	{
+		invokeAll(name, args);
+		return;
+	}
+
+	const auto values = m_values;
+	const auto first = values->cbegin() + m_offset;
+	parallelPool->parallelFor(m_count, ParallelGrainSize, [&name, &args, first](size_t begin, size_t end)
+	{
+		for (auto it = first + begin, last = first + end; it != last; ++it)
+		{
+			const auto f = (*it)->findFunction(name);
+			if (f == nullptr)
+				throw InvalidFunctionName("ArrayObject::parallelInvokeAll", name);
+			(*f)(args);
+		}
+	});
+}
+
+script::ArrayObjectPtr script::ArrayObject::parallelMap(const std::string& name, const ArrayObjectPtr& args, ThreadPool* pool) const
+{
+	const auto parallelPool = getParallelPool(name, "ArrayObject::parallelMap", args.get(), pool);
+	if (parallelPool == nullptr)
+		return mapInvoke(name, args);
+
+	std::vector<ScriptObjectPtr> res(m_count);
+	const auto values = m_values;
+	const auto first = values->cbegin() + m_offset;
+	parallelPool->parallelFor(m_count, ParallelGrainSize, [&name, &args, &res, first](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i != end; ++i)
+		{
+			const auto f = first[i]->findFunction(name);
+			if (f == nullptr)
+				throw InvalidFunctionName("ArrayObject::parallelMap", name);
+			res[i] = (*f)(args);
+		}
+	});
+	return std::make_shared<ArrayObject>(move(res));
+}
+
+script::ScriptObjectPtr script::ArrayObject::parallelReduce(const std::string& name, ThreadPool* pool) const
+{
+	if (m_count == 0)
+		throw std::runtime_error("ArrayObject::parallelReduce array is empty");
+
+	// the accumulators are clones => the elements may occur multiple times
+	const auto parallelPool = getParallelPool(name, "ArrayObject::parallelReduce", nullptr, pool);
+	if (parallelPool == nullptr)
+		return reduceRange(name, 0, m_count);
+
+	std::vector<ScriptObjectPtr> partial((m_count + ParallelGrainSize - 1) / ParallelGrainSize);
+	parallelPool->parallelFor(m_count, ParallelGrainSize, [this, &name, &partial](size_t begin, size_t end)
+	{
+		partial[begin / ParallelGrainSize] = reduceRange(name, begin, end);
+	});
+
+	// combine in order (the function does not need to be commutative)
+	const auto& res = partial.front();
+	const auto f = res->findFunction(name);
+	const auto arg = std::make_shared<ArrayObject>(std::vector<ScriptObjectPtr>(1));
+	for (size_t i = 1; i < partial.size(); ++i)
+	{
+		(*arg->m_values)[0] = partial[i];
+		(*f)(arg);
+	}
+	return res;
+}
+
+script::ThreadPool* script::ArrayObject::getParallelPool(const std::string& name, const char* caller, const ArrayObject* args, ThreadPool* pool) const
+{
+	bool pure = true;
+	std::unordered_set<std::type_index> verified;
+	for (auto it = begin(), last = end(); it != last; ++it)
+	{
+		if (!verified.insert(typeid(**it)).second) continue;
+		if (!(*it)->findFunction(name))
+			throw InvalidFunctionName(caller, name);
+		pure = pure && (*it)->isPure(name);
+	}
+
+	if (pool == nullptr)
+		pool = ThreadPool::getCurrent();
+	if (!pure || pool == nullptr || pool->getThreadCount() == 1 || m_count <= ParallelGrainSize)
+		return nullptr;
+
+	if (args)
+	{
+		// the same object must not be modified by two threads
+		std::unordered_set<const ScriptObject*> objects;
+		objects.reserve(m_count);
+		for (auto it = begin(), last = end(); it != last; ++it)
+			if (!objects.insert(it->get()).second)
+				return nullptr;
+
+		// the arguments are read by all threads => they must not be modified by one of them
+		std::unordered_set<const ScriptObject*> visited;
+		std::vector<const ArrayObject*> pending = { args };
+		while (!pending.empty())
+		{
+			const auto arr = pending.back();
+			pending.pop_back();
+			for (const auto& arg : *arr)
+			{
+				if (objects.count(arg.get()))
+					return nullptr;
+				if (!visited.insert(arg.get()).second)
+					continue;
+				if (auto nested = dynamic_cast<const ArrayObject*>(arg.get()))
+					pending.push_back(nested);
+			}
+		}
+	}
+	return pool;
+}
+
+script::ScriptObjectPtr script::ArrayObject::reduceRange(const std::string& name, size_t begin, size_t end) const
+{
+	const auto first = m_values->cbegin() + m_offset;
+	auto res = first[begin]->clone();
+	const auto f = res->findFunction(name);
+	if (f == nullptr)
+		throw InvalidFunctionName("ArrayObject::parallelReduce", name);
+
+	// one argument array for all calls
+	const auto arg = std::make_shared<ArrayObject>(std::vector<ScriptObjectPtr>(1));
+	for (size_t i = begin + 1; i < end; ++i)
+	{
+		(*arg->m_values)[0] = first[i];
+		(*f)(arg);
+	}
+	return res;
+}
+
+int script::ArrayObject::compare(const ScriptObjectPtr& left, const ScriptObjectPtr& right)
+{
+	if (auto l = dynamic_cast<IntObject*>(left.get()))
+		if (auto r = dynamic_cast<IntObject*>(right.get()))
+			return (l->getValue() > r->getValue()) - (l->getValue() < r->getValue());
+
+	double l, r;
+	if (getNumber(left, l) && getNumber(right, r))
+		return int(lessNumber(r, l)) - int(lessNumber(l, r));
+
+	if (auto ls = dynamic_cast<StringObject*>(left.get()))
+		if (auto rs = dynamic_cast<StringObject*>(right.get()))
+			return ls->getView().compare(rs->getView());
+
+	if (auto lb = dynamic_cast<BoolObject*>(left.get()))
+		if (auto rb = dynamic_cast<BoolObject*>(right.get()))
+			return int(lb->getValue()) - int(rb->getValue());
+
+	// comparison protocol
+	ScriptObjectPtr res;
+	try
+	{
+		res = left->invoke("compareTo", Util::makeArray(right));
+	}
+	catch (const InvalidFunctionName&)
+	{
+		throw std::runtime_error("ArrayObject::compare cannot compare " + left->type() + " with " + right->type() + " (missing compareTo)");
+	}
+	return Util::fromObject<int>(res);
+}
+
+void script::ArrayObject::sortByKeys(const std::vector<ScriptObjectPtr>& keys)
+{
+	assert(m_offset == 0 && m_values->size() == keys.size());
+
+	std::vector<size_t> order;
+	std::vector<std::pair<int, size_t>> ints;
+	std::vector<std::pair<float, size_t>> floats;
+	std::vector<std::pair<std::string_view, size_t>> strings;
+
+	// type specialized keys can be compared without virtual calls (and on multiple threads)
+	if (getKeys<IntObject>(keys, ints, [](IntObject& o) { return o.getValue(); }))
+		order = getOrder(ints, std::less<int>());
+	else if (getKeys<FloatObject>(keys, floats, [](FloatObject& o) { return o.getValue(); }))
+		order = getOrder(floats, [](float a, float b) { return lessNumber(a, b); });
+	else if (getKeys<StringObject>(keys, strings, [](StringObject& o) { return o.getView(); }))
+		order = getOrder(strings, std::less<std::string_view>());
+	else
+	{
+		// the comparison may call script functions => single threaded
+		order.resize(keys.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b)
+		{
+			return compare(keys[a], keys[b]) < 0;
+		});
+	}
+
+	std::vector<ScriptObjectPtr> sorted;
+	sorted.reserve(order.size());
+	for (auto i : order)
+		sorted.push_back(std::move((*m_values)[i]));
+	*m_values = std::move(sorted);
+}
+
 std::vector<script::ScriptObjectPtr>::iterator script::ArrayObject::begin()
 {
-	return m_values.begin();
+	// elements may be overwritten through the iterator
+	detach();
+	return m_values->begin();
 }
 
 std::vector<script::ScriptObjectPtr>::iterator script::ArrayObject::end()
 {
-	return m_values.end();
+	detach();
+	return m_values->end();
 }
 
 std::vector<script::ScriptObjectPtr>::const_iterator script::ArrayObject::begin() const
 {
-	return m_values.cbegin();
+	return m_values->cbegin() + m_offset;
 }
 
 std::vector<script::ScriptObjectPtr>::const_iterator script::ArrayObject::end() const
 {
-	return m_values.cend();
+	return m_values->cbegin() + (m_offset + m_count);
 }
 
 int script::ArrayObject::getCount() const
 {
-	return static_cast<int>(m_values.size());
+	return static_cast<int>(m_count);
 }
 
 script::ScriptObjectPtr script::ArrayObject::clone() const
 {
-	decltype(m_values) copy;
-	copy.reserve(m_values.size());
-	for (const auto& v : m_values)
+	// elements are mutable and may be referenced elsewhere => a deep copy can not share the storage
+	std::vector<ScriptObjectPtr> copy;
+	copy.reserve(m_count);
+	for (auto it = begin(), last = end(); it != last; ++it)
 	{
-		copy.push_back(v->clone());
+		copy.push_back((*it)->clone());
 	}
-	return std::make_shared<ArrayObject>(copy);
+	return std::make_shared<ArrayObject>(move(copy));
 }
 
 bool script::ArrayObject::equals(const ScriptObjectPtr& other) const
@@ -163,13 +657,48 @@ bool script::ArrayObject::equals(const ScriptObjectPtr& other) const
 	const auto arr = dynamic_cast<const ArrayObject*>(other.get());
 	if (arr == nullptr) return false;
 
-	if (getCount() != arr->getCount())
+	if (m_count != arr->m_count)
 		return false;
 
+	// same range of the same storage
+	if (m_values == arr->m_values && m_offset == arr->m_offset)
+		return true;
+
 	// memberwise compare
-	for (int i = 0; i < getCount(); ++i)
-		if (!m_values[i]->equals(arr->m_values[i]))
+	for (auto it = begin(), last = end(), it2 = arr->begin(); it != last; ++it, ++it2)
+		if (it->get() != it2->get() && !(*it)->equals(*it2))
 			return false;
 
 	return true;
 }
+
+size_t script::ArrayObject::hashCode() const
+{
+	// the array contains itself => stop the recursion
+	const RecursionGuard guard(this, RecursionGuard::Operation::HashCode);
+	if (guard.isRecursive())
+		return 0;
+
+	size_t res = m_count;
+	for (auto it = begin(), last = end(); it != last; ++it)
+		res = hash::combine(res, (*it)->hashCode());
+	return res;
+}
+
+void script::ArrayObject::detach()
+{
+	if (m_values.use_count() == 1)
+	{
+		// sole owner => only drop elements outside of the visible range
+		if (m_offset + m_count != m_values->size())
+			m_values->erase(m_values->begin() + (m_offset + m_count), m_values->end());
+		if (m_offset != 0)
+			m_values->erase(m_values->begin(), m_values->begin() + m_offset);
+		m_offset = 0;
+		return;
+	}
+
+	const auto first = m_values->cbegin() + m_offset;
+	m_values = std::make_shared<std::vector<ScriptObjectPtr>>(first, first + m_count);
+	m_offset = 0;
+}
@@ -0,0 +1,36 @@
+#include "../../../include/script/objects/FloatArrayObject.h"
+#include "../../../include/script/Util.h"
+
+script::FloatArrayObject::FloatArrayObject()
+	:
+FloatArrayObject(std::vector<float>{})
+{}
+
+script::FloatArrayObject::FloatArrayObject(std::vector<float> values)
+	:
+NumericArrayObject(std::move(values))
+{}
+
+script::ScriptObject::FunctionT script::FloatArrayObject::getCtor()
+{
+	return Util::combineFunctions({
+		Util::fromLambda([]()
+		{
+			return std::make_shared<FloatArrayObject>();
+		}, "FloatArray()"),
+		Util::fromLambda([](std::vector<float> values)
+		{
+			return std::make_shared<FloatArrayObject>(move(values));
+		}, "FloatArray(float[] values)")
+	});
+}
+
+script::ScriptPtr<script::NumericArrayObject<float>> script::FloatArrayObject::make(std::vector<float> values) const
+{
+	return std::make_shared<FloatArrayObject>(move(values));
+}
+
+script::ScriptObjectPtr script::Util::makeObject(const std::vector<float>& vec)
+{
+	return std::make_shared<FloatArrayObject>(vec);
+}
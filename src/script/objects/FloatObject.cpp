@@ -8,7 +8,7 @@ NumericalObject(value)
 
 std::string script::FloatObject::toString() const
 {
-	return std::to_string(m_value);
+	return Util::numberToString(m_value);
 }
 
 script::ScriptObjectPtr script::FloatObject::clone() const
@@ -34,7 +34,7 @@ script::ScriptObject::FunctionT script::FloatObject::getCtor()
 		}, "Float(int)"),
 		Util::fromLambda([](const std::string& val)
 		{
-			return std::make_shared<FloatObject>(std::stof(val));
+			return std::make_shared<FloatObject>(Util::parseNumber<float>(val));
 		}, "Float(string)"),
 	});
 }
@@ -0,0 +1,36 @@
+#include "../../../include/script/objects/IntArrayObject.h"
+#include "../../../include/script/Util.h"
+
+script::IntArrayObject::IntArrayObject()
+	:
+IntArrayObject(std::vector<int>{})
+{}
+
+script::IntArrayObject::IntArrayObject(std::vector<int> values)
+	:
+NumericArrayObject(std::move(values))
+{}
+
+script::ScriptObject::FunctionT script::IntArrayObject::getCtor()
+{
+	return Util::combineFunctions({
+		Util::fromLambda([]()
+		{
+			return std::make_shared<IntArrayObject>();
+		}, "IntArray()"),
+		Util::fromLambda([](std::vector<int> values)
+		{
+			return std::make_shared<IntArrayObject>(move(values));
+		}, "IntArray(int[] values)")
+	});
+}
+
+script::ScriptPtr<script::NumericArrayObject<int>> script::IntArrayObject::make(std::vector<int> values) const
+{
+	return std::make_shared<IntArrayObject>(move(values));
+}
+
+script::ScriptObjectPtr script::Util::makeObject(const std::vector<int>& vec)
+{
+	return std::make_shared<IntArrayObject>(vec);
+}
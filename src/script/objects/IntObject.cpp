@@ -19,14 +19,14 @@ script::ScriptObject::FunctionT script::IntObject::getCtor()
 		}, "Int(float)"),
 		Util::fromLambda([](const std::string& val)
 		{
-			return std::make_shared<IntObject>(std::stoi(val));
+			return std::make_shared<IntObject>(Util::parseNumber<int>(val));
 		}, "Int(string)")
 	});
 }
 
 std::string script::IntObject::toString() const
 {
-	return std::to_string(m_value);
+	return Util::numberToString(m_value);
 }
 
 script::ScriptObjectPtr script::IntObject::clone() const
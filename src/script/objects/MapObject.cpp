@@ -0,0 +1,340 @@
+#include "../../../include/script/objects/MapObject.h"
+#include "../../../include/script/Util.h"
+#include "../../../include/script/OutputSink.h"
+#include "../../../include/script/RecursionGuard.h"
+#include "../../../include/script/Hash.h"
+#include <cstdint>
+
+namespace
+{
+	constexpr size_t MinCapacity = 8;
+
+	size_t nextPowerOfTwo(size_t value)
+	{
+		size_t res = MinCapacity;
+		while (res < value)
+			res *= 2;
+		return res;
+	}
+}
+
+script::MapObject::MapObject()
+{
+	addFunction("get", Util::combineFunctions({
+		Util::makeFunction(this, static_cast<const ScriptObjectPtr&(MapObject::*)(const ScriptObjectPtr&) const>(&MapObject::get), "object MapObject::get(object key)"),
+		Util::makeFunction(this, static_cast<ScriptObjectPtr(MapObject::*)(const ScriptObjectPtr&, const ScriptObjectPtr&) const>(&MapObject::get), "object MapObject::get(object key, object default)")
+	}));
+	addFunction("set", Util::makeFunction(this, &MapObject::set, "MapObject::set(object key, object value)"));
+	addFunction("has", Util::makeFunction(this, &MapObject::has, "bool MapObject::has(object key)"));
+	addFunction("remove", Util::makeFunction(this, &MapObject::remove, "bool MapObject::remove(object key)"));
+	addFunction("clear", Util::makeFunction(this, &MapObject::clear, "MapObject::clear()"));
+	addFunction("getCount", Util::makeFunction(this, &MapObject::getCount, "int MapObject::getCount()"));
+	addFunction("getKeys", Util::makeFunction(this, &MapObject::getKeys, "ArrayObject MapObject::getKeys()"));
+	addFunction("getValues", Util::makeFunction(this, &MapObject::getValues, "ArrayObject MapObject::getValues()"));
+	addFunction("reserve", Util::makeFunction(this, &MapObject::reserve, "MapObject::reserve(int count)"));
+	addFunction("rehash", Util::makeFunction(this, &MapObject::rehash, "MapObject::rehash(int capacity)"));
+	addFunction("getCapacity", Util::makeFunction(this, &MapObject::getCapacity, "int MapObject::getCapacity()"));
+}
+
+script::ScriptObject::FunctionT script::MapObject::getCtor()
+{
+	return Util::fromLambda([]()
+	{
+		return std::make_shared<MapObject>();
+	}, "Map()");
+}
+
+std::string script::MapObject::toString() const
+{
+	StringSink sink;
+	writeTo(sink);
+	return sink.release();
+}
+
+void script::MapObject::writeTo(OutputSink& sink) const
+{
+	if (m_count == 0)
+	{
+		sink.write("{}");
+		return;
+	}
+
+	const RecursionGuard guard(this, RecursionGuard::Operation::ToString);
+	if (guard.isRecursive())
+	{
+		sink.write("{...}");
+		return;
+	}
+
+	sink.write('{');
+	bool first = true;
+	for (const auto& slot : m_slots)
+	{
+		if (!slot.key) continue;
+		if (!first)
+			sink.write(", ");
+		first = false;
+		if (sink.isFull())
+		{
+			sink.setTruncated();
+			return;
+		}
+
+		slot.key->writeTo(sink);
+		sink.write(": ");
+		slot.value->writeTo(sink);
+	}
+	sink.write('}');
+}
+
+script::ScriptObjectPtr script::MapObject::clone() const
+{
+	auto res = std::make_shared<MapObject>();
+	res->m_maxLoadFactor = m_maxLoadFactor;
+	// the keys are private copies => they can be shared
+	res->m_slots = m_slots;
+	res->m_count = m_count;
+	for (auto& slot : res->m_slots)
+		if (slot.key) slot.value = slot.value->clone();
+
+	return res;
+}
+
+bool script::MapObject::equals(const ScriptObjectPtr& other) const
+{
+	if (this == other.get()) return true;
+
+	const auto map = dynamic_cast<const MapObject*>(other.get());
+	if (map == nullptr) return false;
+	if (m_count != map->m_count) return false;
+
+	for (const auto& slot : m_slots)
+	{
+		if (!slot.key) continue;
+		const auto idx = map->findSlot(slot.key, slot.hash);
+		if (idx == size_t(-1)) return false;
+		const auto& value = map->m_slots[idx].value;
+		if (value.get() != slot.value.get() && !slot.value->equals(value))
+			return false;
+	}
+	return true;
+}
+
+size_t script::MapObject::hashCode() const
+{
+	// the map contains itself => stop the recursion
+	const RecursionGuard guard(this, RecursionGuard::Operation::HashCode);
+	if (guard.isRecursive())
+		return 0;
+
+	// the slot order depends on the insertion history => sum is order independent
+	size_t res = m_count;
+	for (const auto& slot : m_slots)
+		if (slot.key) res += hash::combine(slot.hash, slot.value->hashCode());
+	return res;
+}
+
+const script::ScriptObjectPtr& script::MapObject::get(const ScriptObjectPtr& key) const
+{
+	const auto idx = findSlot(key, key->hashCode());
+	if (idx == size_t(-1))
+		throw std::out_of_range("MapObject::get key not found: " + key->toString());
+
+	return m_slots[idx].value;
+}
+
+script::ScriptObjectPtr script::MapObject::get(const ScriptObjectPtr& key, const ScriptObjectPtr& defaultValue) const
+{
+	const auto idx = findSlot(key, key->hashCode());
+	if (idx == size_t(-1))
+		return defaultValue;
+
+	return m_slots[idx].value;
+}
+
+script::ScriptObjectPtr script::MapObject::find(const ScriptObjectPtr& key) const
+{
+	return get(key, nullptr);
+}
+
+void script::MapObject::set(const ScriptObjectPtr& key, ScriptObjectPtr value)
+{
+	const auto hash = key->hashCode();
+	const auto idx = findSlot(key, hash);
+	if (idx != size_t(-1))
+	{
+		m_slots[idx].value = move(value);
+		return;
+	}
+
+	if (float(m_count + 1) > float(m_slots.size()) * m_maxLoadFactor)
+		resize(m_slots.size() * 2);
+
+	// keys must not change while they are in the map
+	ScriptObjectPtr keyCopy;
+	try
+	{
+		keyCopy = key->clone();
+	}
+	catch (const ObjectNotCloneableException&)
+	{
+		// compared by reference
+		keyCopy = key;
+	}
+
+	const size_t mask = m_slots.size() - 1;
+	size_t i = getBucket(hash);
+	while (m_slots[i].key)
+		i = (i + 1) & mask;
+
+	m_slots[i].key = move(keyCopy);
+	m_slots[i].value = move(value);
+	m_slots[i].hash = hash;
+	++m_count;
+}
+
+bool script::MapObject::has(const ScriptObjectPtr& key) const
+{
+	return findSlot(key, key->hashCode()) != size_t(-1);
+}
+
+bool script::MapObject::remove(const ScriptObjectPtr& key)
+{
+	size_t hole = findSlot(key, key->hashCode());
+	if (hole == size_t(-1))
+		return false;
+
+	// backward shift deletion: move following entries of the probe sequence into the hole
+	const size_t mask = m_slots.size() - 1;
+	size_t next = (hole + 1) & mask;
+	while (m_slots[next].key)
+	{
+		const size_t ideal = getBucket(m_slots[next].hash);
+		// the entry may be moved if the hole lies between its ideal slot and its current slot
+		if (((next - ideal) & mask) >= ((next - hole) & mask))
+		{
+			m_slots[hole] = std::move(m_slots[next]);
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+
+	m_slots[hole] = Slot();
+	--m_count;
+	return true;
+}
+
+void script::MapObject::clear()
+{
+	m_slots.clear();
+	m_count = 0;
+}
+
+int script::MapObject::getCount() const
+{
+	return int(m_count);
+}
+
+script::ArrayObjectPtr script::MapObject::getKeys() const
+{
+	std::vector<ScriptObjectPtr> res;
+	res.reserve(m_count);
+	// the keys of the map must not be modified
+	forEach([&res](const ScriptObjectPtr& key, const ScriptObjectPtr&)
+	{
+		try
+		{
+			res.push_back(key->clone());
+		}
+		catch (const ObjectNotCloneableException&)
+		{
+			res.push_back(key);
+		}
+	});
+	return std::make_shared<ArrayObject>(move(res));
+}
+
+script::ArrayObjectPtr script::MapObject::getValues() const
+{
+	std::vector<ScriptObjectPtr> res;
+	res.reserve(m_count);
+	forEach([&res](const ScriptObjectPtr&, const ScriptObjectPtr& value)
+	{
+		res.push_back(value);
+	});
+	return std::make_shared<ArrayObject>(move(res));
+}
+
+void script::MapObject::reserve(int count)
+{
+	if (count < 0)
+		throw std::runtime_error("MapObject::reserve count may not be smaller than zero");
+
+	const auto required = size_t(std::ceil(float(count) / m_maxLoadFactor));
+	if (required > m_slots.size())
+		resize(required);
+}
+
+void script::MapObject::rehash(int capacity)
+{
+	if (capacity < 0)
+		throw std::runtime_error("MapObject::rehash capacity may not be smaller than zero");
+
+	const auto required = size_t(std::ceil(float(m_count) / m_maxLoadFactor));
+	resize(std::max(size_t(capacity), required));
+}
+
+int script::MapObject::getCapacity() const
+{
+	return int(m_slots.size());
+}
+
+void script::MapObject::setMaxLoadFactor(float factor)
+{
+	if (!(factor > 0.0f && factor < 1.0f))
+		throw std::runtime_error("MapObject::setMaxLoadFactor factor must be in (0, 1)");
+
+	m_maxLoadFactor = factor;
+	reserve(int(m_count));
+}
+
+float script::MapObject::getMaxLoadFactor() const
+{
+	return m_maxLoadFactor;
+}
+
+size_t script::MapObject::findSlot(const ScriptObjectPtr& key, size_t hash) const
+{
+	if (m_slots.empty())
+		return size_t(-1);
+
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = getBucket(hash); m_slots[i].key; i = (i + 1) & mask)
+	{
+		const auto& slot = m_slots[i];
+		if (slot.hash == hash && (slot.key.get() == key.get() || slot.key->equals(key)))
+			return i;
+	}
+	return size_t(-1);
+}
+
+size_t script::MapObject::getBucket(size_t hash) const
+{
+	// fibonacci hashing spreads the bits of weak hashes (e.g. identity hash of integers)
+	return size_t(uint64_t(hash) * 0x9E3779B97F4A7C15ull >> 32) & (m_slots.size() - 1);
+}
+
+void script::MapObject::resize(size_t capacity)
+{
+	auto old = std::move(m_slots);
+	m_slots = std::vector<Slot>(nextPowerOfTwo(capacity));
+	const size_t mask = m_slots.size() - 1;
+	for (auto& slot : old)
+	{
+		if (!slot.key) continue;
+		size_t i = getBucket(slot.hash);
+		while (m_slots[i].key)
+			i = (i + 1) & mask;
+		m_slots[i] = std::move(slot);
+	}
+}
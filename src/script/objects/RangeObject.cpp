@@ -0,0 +1,222 @@
+#include "../../../include/script/objects/RangeObject.h"
+#include "../../../include/script/objects/IntObject.h"
+#include "../../../include/script/objects/FloatObject.h"
+#include "../../../include/script/Util.h"
+#include "../../../include/script/Exception.h"
+
+script::RangeObject::RangeObject(int from, int to, int step)
+	:
+m_from(from),
+m_to(to),
+m_step(step)
+{
+	if (step == 0)
+		throw std::runtime_error("RangeObject step may not be zero");
+
+	setFunctions();
+}
+
+void script::RangeObject::setFunctions()
+{
+	// map and filter forward the remaining arguments to the function
+	auto pipeline = [this](ScriptPtr<RangeObject>(RangeObject::* stage)(const std::string&, ArrayObjectPtr) const, const std::string& signature)
+	{
+		return [this, stage, signature](const ArrayObjectPtr& args) -> ScriptObjectPtr
+		{
+			if (args->getCount() == 0)
+				throw InvalidArgumentCount(signature, 1, 0);
+			const auto function = Util::fromObject<std::string>(args->get(0));
+			return (this->*stage)(function, args->getCount() > 1 ? args->slice(1) : std::make_shared<ArrayObject>());
+		};
+	};
+	addFunction("map", pipeline(&RangeObject::map, "RangeObject RangeObject::map(string function, args...)"));
+	addFunction("filter", pipeline(&RangeObject::filter, "RangeObject RangeObject::filter(string function, args...)"));
+	addFunction("take", Util::makeFunction(this, &RangeObject::take, "RangeObject RangeObject::take(int count)"));
+	addFunction("skip", Util::makeFunction(this, &RangeObject::skip, "RangeObject RangeObject::skip(int count)"));
+	addFunction("sum", Util::makeFunction(this, &RangeObject::sum, "object RangeObject::sum()"));
+	addFunction("toArray", Util::makeFunction(this, &RangeObject::toArray, "ArrayObject RangeObject::toArray()"));
+	addFunction("getCount", Util::makeFunction(this, &RangeObject::getCount, "int RangeObject::getCount()"));
+}
+
+script::ScriptObject::FunctionT script::RangeObject::getCtor()
+{
+	return Util::combineFunctions({
+		Util::fromLambda([](int to)
+		{
+			return std::make_shared<RangeObject>(0, to);
+		}, "Range(int to)"),
+		Util::fromLambda([](int from, int to)
+		{
+			return std::make_shared<RangeObject>(from, to);
+		}, "Range(int from, int to)"),
+		Util::fromLambda([](int from, int to, int step)
+		{
+			return std::make_shared<RangeObject>(from, to, step);
+		}, "Range(int from, int to, int step)")
+	});
+}
+
+std::string script::RangeObject::toString() const
+{
+	std::string res = "Range(" + Util::numberToString(m_from) + ", " + Util::numberToString(m_to) + ", " + Util::numberToString(m_step) + ")";
+	for (const auto& s : m_stages)
+	{
+		switch (s.type)
+		{
+		case Stage::Map: res += ".map(\"" + s.function + "\")"; break;
+		case Stage::Filter: res += ".filter(\"" + s.function + "\")"; break;
+		case Stage::Take: res += ".take(" + Util::numberToString(s.count) + ")"; break;
+		case Stage::Skip: res += ".skip(" + Util::numberToString(s.count) + ")"; break;
+		}
+	}
+	return res;
+}
+
+script::ScriptObjectPtr script::RangeObject::clone() const
+{
+	auto res = std::make_shared<RangeObject>(m_from, m_to, m_step);
+	res->m_stages = m_stages;
+	return res;
+}
+
+script::RangeObjectPtr script::RangeObject::map(const std::string& function, ArrayObjectPtr args) const
+{
+	return append({ Stage::Map, function, move(args), 0 });
+}
+
+script::RangeObjectPtr script::RangeObject::filter(const std::string& function, ArrayObjectPtr args) const
+{
+	return append({ Stage::Filter, function, move(args), 0 });
+}
+
+script::RangeObjectPtr script::RangeObject::take(int count) const
+{
+	if (count < 0)
+		throw std::runtime_error("RangeObject::take count may not be smaller than zero");
+	return append({ Stage::Take, std::string(), nullptr, count });
+}
+
+script::RangeObjectPtr script::RangeObject::skip(int count) const
+{
+	if (count < 0)
+		throw std::runtime_error("RangeObject::skip count may not be smaller than zero");
+	return append({ Stage::Skip, std::string(), nullptr, count });
+}
+
+script::ScriptObjectPtr script::RangeObject::sum() const
+{
+	if (isPlain())
+	{
+		// no objects required
+		long long total = 0;
+		run([&total](int value, const ScriptObjectPtr&) { total += value; });
+		return Util::makeObject(int(total));
+	}
+
+	ScriptObjectPtr res;
+	forEach([&res](const ScriptObjectPtr& obj)
+	{
+		if (!res)
+		{
+			// the element may be referenced elsewhere (e.g. map("get", ...))
+			res = obj->clone();
+			return;
+		}
+
+		// add the plain values if possible
+		if (auto i = dynamic_cast<IntObject*>(res.get()))
+			if (auto o = dynamic_cast<IntObject*>(obj.get()))
+			{
+				i->add(o->getValue());
+				return;
+			}
+		if (auto f = dynamic_cast<FloatObject*>(res.get()))
+			if (auto o = dynamic_cast<FloatObject*>(obj.get()))
+			{
+				f->add(o->getValue());
+				return;
+			}
+
+		res->invoke("add", Util::makeArray(obj));
+	});
+
+	if (!res)
+		return Util::makeObject(0);
+	return res;
+}
+
+script::ArrayObjectPtr script::RangeObject::toArray() const
+{
+	auto res = std::make_shared<ArrayObject>();
+	forEach([&res](const ScriptObjectPtr& obj)
+	{
+		res->add(obj);
+	});
+	return res;
+}
+
+int script::RangeObject::getCount() const
+{
+	int count = 0;
+	run([&count](int, const ScriptObjectPtr&) { ++count; });
+	return count;
+}
+
+script::RangeObjectPtr script::RangeObject::append(Stage stage) const
+{
+	auto res = std::make_shared<RangeObject>(m_from, m_to, m_step);
+	res->m_stages.reserve(m_stages.size() + 1);
+	res->m_stages = m_stages;
+	res->m_stages.push_back(std::move(stage));
+	return res;
+}
+
+bool script::RangeObject::apply(int value, ScriptObjectPtr& obj, std::vector<int>& counters, bool& last) const
+{
+	for (size_t i = 0; i < m_stages.size(); ++i)
+	{
+		const auto& s = m_stages[i];
+		switch (s.type)
+		{
+		case Stage::Take:
+			if (counters[i] >= s.count)
+			{
+				last = true;
+				return false;
+			}
+			if (++counters[i] == s.count)
+				last = true;
+			break;
+		case Stage::Skip:
+			if (counters[i] < s.count)
+			{
+				++counters[i];
+				return false;
+			}
+			break;
+		case Stage::Map:
+			if (!obj) obj = makeInt(value);
+			obj = obj->invoke(s.function, s.args);
+			break;
+		case Stage::Filter:
+			if (!obj) obj = makeInt(value);
+			if (!Util::fromObject<bool>(obj->invoke(s.function, s.args)))
+				return false;
+			break;
+		}
+	}
+	return true;
+}
+
+bool script::RangeObject::isPlain() const
+{
+	for (const auto& s : m_stages)
+		if (s.type == Stage::Map || s.type == Stage::Filter)
+			return false;
+	return true;
+}
+
+script::ScriptObjectPtr script::RangeObject::makeInt(int value)
+{
+	return std::make_shared<IntObject>(value);
+}
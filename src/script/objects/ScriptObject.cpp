@@ -1,6 +1,7 @@
 #include "../../../include/script/objects/ScriptObject.h"
 #include "../../../include/script/objects/ArrayObject.h"
 #include "../../../include/script/Util.h"
+#include "../../../include/script/OutputSink.h"
 #include <cctype>
 #include <any>
 #include <algorithm>
@@ -21,6 +22,11 @@ std::string script::ScriptObject::toString() const
 	return type();
 }
 
+void script::ScriptObject::writeTo(OutputSink& sink) const
+{
+	sink.write(toString());
+}
+
 script::ScriptObjectPtr script::ScriptObject::clone() const
 {
 	throw ObjectNotCloneableException(type());
@@ -51,6 +57,21 @@ script::ScriptObjectPtr script::ScriptObject::invoke(const std::string& funcName
 	return it->second(args);
 }
 
+const script::ScriptObject::FunctionT* script::ScriptObject::findFunction(const std::string& funcName) const
+{
+	const auto it = m_functions.find(funcName);
+	if (it == m_functions.end())
+		return nullptr;
+
+	return &it->second;
+}
+
+bool script::ScriptObject::isPure(const std::string& funcName) const
+{
+	const auto func = findFunction(funcName);
+	return func != nullptr && func->target<Util::PureFunction>() != nullptr;
+}
+
 std::vector<std::string> script::ScriptObject::getFunctions() const
 {
 	std::vector<std::string> res;
@@ -0,0 +1,367 @@
+#include "../../../include/script/objects/SetObject.h"
+#include "../../../include/script/objects/IntObject.h"
+#include "../../../include/script/Util.h"
+#include "../../../include/script/OutputSink.h"
+#include "../../../include/script/RecursionGuard.h"
+#include "../../../include/script/Hash.h"
+#include "../../../include/script/Exception.h"
+#include <algorithm>
+#include <iterator>
+
+script::SetObject::SetObject()
+{
+	setFunctions();
+}
+
+script::SetObject::SetObject(const ArrayObject& values)
+{
+	setFunctions();
+	addAll(values);
+}
+
+script::SetObject::SetObject(std::vector<int> values)
+	:
+m_ints(move(values))
+{
+	setFunctions();
+	std::sort(m_ints.begin(), m_ints.end());
+	m_ints.erase(std::unique(m_ints.begin(), m_ints.end()), m_ints.end());
+}
+
+void script::SetObject::setFunctions()
+{
+	addFunction("add", Util::makeFunction(this, &SetObject::add, "bool SetObject::add(object value)"));
+	addFunction("addAll", Util::makeFunction(this, &SetObject::addAll, "SetObject::addAll(ArrayObject values)"));
+	addFunction("has", Util::makeFunction(this, &SetObject::has, "bool SetObject::has(object value)"));
+	addFunction("remove", Util::makeFunction(this, &SetObject::remove, "bool SetObject::remove(object value)"));
+	addFunction("clear", Util::makeFunction(this, &SetObject::clear, "SetObject::clear()"));
+	addFunction("getCount", Util::makeFunction(this, &SetObject::getCount, "int SetObject::getCount()"));
+	addFunction("toArray", Util::makeFunction(this, &SetObject::toArray, "ArrayObject SetObject::toArray()"));
+	addFunction("getUnion", Util::makeFunction(this, &SetObject::getUnion, "SetObject SetObject::getUnion(SetObject other)"));
+	addFunction("getIntersection", Util::makeFunction(this, &SetObject::getIntersection, "SetObject SetObject::getIntersection(SetObject other)"));
+	addFunction("getDifference", Util::makeFunction(this, &SetObject::getDifference, "SetObject SetObject::getDifference(SetObject other)"));
+}
+
+script::ScriptObject::FunctionT script::SetObject::getCtor()
+{
+	return Util::combineFunctions({
+		Util::fromLambda([]()
+		{
+			return std::make_shared<SetObject>();
+		}, "Set()"),
+		Util::fromLambda([](const ScriptPtr<GetValueObject<std::vector<int>>>& values)
+		{
+			return std::make_shared<SetObject>(values->getValue());
+		}, "Set(IntArrayObject values)"),
+		Util::fromLambda([](const ArrayObjectPtr& values)
+		{
+			return std::make_shared<SetObject>(*values);
+		}, "Set(ArrayObject values)")
+	});
+}
+
+std::string script::SetObject::toString() const
+{
+	StringSink sink;
+	writeTo(sink);
+	return sink.release();
+}
+
+void script::SetObject::writeTo(OutputSink& sink) const
+{
+	if (getCount() == 0)
+	{
+		sink.write("{}");
+		return;
+	}
+
+	const RecursionGuard guard(this, RecursionGuard::Operation::ToString);
+	if (guard.isRecursive())
+	{
+		sink.write("{...}");
+		return;
+	}
+
+	sink.write('{');
+	bool first = true;
+	auto writeMember = [&](const auto& write)
+	{
+		if (!first)
+			sink.write(", ");
+		first = false;
+		if (sink.isFull())
+		{
+			sink.setTruncated();
+			return false;
+		}
+		write();
+		return true;
+	};
+
+	if (m_flat)
+	{
+		for (int v : m_ints)
+		{
+			char buffer[Util::MaxNumberLength];
+			if (!writeMember([&]() { sink.write(std::string_view(buffer, Util::writeNumber(buffer, v) - buffer)); }))
+				return;
+		}
+	}
+	else
+	{
+		for (const auto& v : m_objects)
+			if (!writeMember([&]() { v->writeTo(sink); }))
+				return;
+	}
+	sink.write('}');
+}
+
+script::ScriptObjectPtr script::SetObject::clone() const
+{
+	// the members are private copies => they can be shared
+	auto res = std::make_shared<SetObject>();
+	res->m_flat = m_flat;
+	res->m_ints = m_ints;
+	res->m_objects = m_objects;
+	return res;
+}
+
+bool script::SetObject::equals(const ScriptObjectPtr& other) const
+{
+	if (this == other.get()) return true;
+
+	const auto set = dynamic_cast<const SetObject*>(other.get());
+	if (set == nullptr) return false;
+	if (getCount() != set->getCount()) return false;
+
+	if (m_flat && set->m_flat)
+		return m_ints == set->m_ints;
+
+	bool res = true;
+	forEach([&](const ScriptObjectPtr& v)
+	{
+		res = res && set->has(v);
+	});
+	return res;
+}
+
+size_t script::SetObject::hashCode() const
+{
+	// the set contains itself => stop the recursion
+	const RecursionGuard guard(this, RecursionGuard::Operation::HashCode);
+	if (guard.isRecursive())
+		return 0;
+
+	// the hash of an integer member equals the hash of the IntObject
+	size_t res = size_t(getCount());
+	for (int v : m_ints)
+		res += hash::value(v);
+	for (const auto& v : m_objects)
+		res += v->hashCode();
+	return res;
+}
+
+bool script::SetObject::add(const ScriptObjectPtr& value)
+{
+	int i;
+	if (m_flat && getInt(value, i))
+	{
+		const auto it = std::lower_bound(m_ints.begin(), m_ints.end(), i);
+		if (it != m_ints.end() && *it == i)
+			return false;
+		m_ints.insert(it, i);
+		return true;
+	}
+
+	if (has(value))
+		return false;
+
+	unflatten();
+	try
+	{
+		m_objects.insert(value->clone());
+	}
+	catch (const ObjectNotCloneableException&)
+	{
+		// compared by reference
+		m_objects.insert(value);
+	}
+	return true;
+}
+
+void script::SetObject::addAll(const ArrayObject& values)
+{
+	if (m_flat)
+	{
+		// collect the integers and merge them at once
+		std::vector<int> ints;
+		ints.reserve(values.getCount());
+		int i;
+		for (const auto& v : values)
+		{
+			if (!getInt(v, i)) break;
+			ints.push_back(i);
+		}
+
+		if (ints.size() == size_t(values.getCount()))
+		{
+			std::sort(ints.begin(), ints.end());
+			const auto middle = m_ints.size();
+			m_ints.insert(m_ints.end(), ints.begin(), ints.end());
+			std::inplace_merge(m_ints.begin(), m_ints.begin() + middle, m_ints.end());
+			m_ints.erase(std::unique(m_ints.begin(), m_ints.end()), m_ints.end());
+			return;
+		}
+	}
+
+	for (const auto& v : values)
+		add(v);
+}
+
+bool script::SetObject::has(const ScriptObjectPtr& value) const
+{
+	if (m_flat)
+	{
+		int i;
+		return getInt(value, i) && std::binary_search(m_ints.begin(), m_ints.end(), i);
+	}
+	return m_objects.find(value) != m_objects.end();
+}
+
+bool script::SetObject::remove(const ScriptObjectPtr& value)
+{
+	if (m_flat)
+	{
+		int i;
+		if (!getInt(value, i)) return false;
+		const auto it = std::lower_bound(m_ints.begin(), m_ints.end(), i);
+		if (it == m_ints.end() || *it != i)
+			return false;
+		m_ints.erase(it);
+		return true;
+	}
+	return m_objects.erase(value) != 0;
+}
+
+void script::SetObject::clear()
+{
+	m_ints.clear();
+	m_objects.clear();
+	m_flat = true;
+}
+
+int script::SetObject::getCount() const
+{
+	return int(m_flat ? m_ints.size() : m_objects.size());
+}
+
+script::ArrayObjectPtr script::SetObject::toArray() const
+{
+	// the members must not be modified => return copies
+	std::vector<ScriptObjectPtr> res;
+	res.reserve(getCount());
+	for (int v : m_ints)
+		res.push_back(makeInt(v));
+	for (const auto& v : m_objects)
+	{
+		try
+		{
+			res.push_back(v->clone());
+		}
+		catch (const ObjectNotCloneableException&)
+		{
+			res.push_back(v);
+		}
+	}
+	return std::make_shared<ArrayObject>(move(res));
+}
+
+script::SetObjectPtr script::SetObject::getUnion(const SetObject& other) const
+{
+	auto res = std::make_shared<SetObject>();
+	if (m_flat && other.m_flat)
+	{
+		res->m_ints.reserve(m_ints.size() + other.m_ints.size());
+		std::set_union(m_ints.begin(), m_ints.end(), other.m_ints.begin(), other.m_ints.end(), std::back_inserter(res->m_ints));
+		return res;
+	}
+
+	res->unflatten();
+	res->m_objects.reserve(getCount() + other.getCount());
+	forEach([&res](const ScriptObjectPtr& v) { res->m_objects.insert(v); });
+	other.forEach([&res](const ScriptObjectPtr& v) { res->m_objects.insert(v); });
+	return res;
+}
+
+script::SetObjectPtr script::SetObject::getIntersection(const SetObject& other) const
+{
+	auto res = std::make_shared<SetObject>();
+	if (m_flat && other.m_flat)
+	{
+		std::set_intersection(m_ints.begin(), m_ints.end(), other.m_ints.begin(), other.m_ints.end(), std::back_inserter(res->m_ints));
+		return res;
+	}
+
+	// probe the larger set with the members of the smaller set
+	const auto& small = getCount() <= other.getCount() ? *this : other;
+	const auto& large = &small == this ? other : *this;
+	res->unflatten();
+	small.forEach([&res, &large](const ScriptObjectPtr& v)
+	{
+		if (large.has(v)) res->m_objects.insert(v);
+	});
+	return res;
+}
+
+script::SetObjectPtr script::SetObject::getDifference(const SetObject& other) const
+{
+	auto res = std::make_shared<SetObject>();
+	if (m_flat && other.m_flat)
+	{
+		std::set_difference(m_ints.begin(), m_ints.end(), other.m_ints.begin(), other.m_ints.end(), std::back_inserter(res->m_ints));
+		return res;
+	}
+
+	if (m_flat)
+	{
+		// the result only contains integers
+		for (int v : m_ints)
+			if (!other.has(makeInt(v))) res->m_ints.push_back(v);
+		return res;
+	}
+
+	res->unflatten();
+	for (const auto& v : m_objects)
+		if (!other.has(v)) res->m_objects.insert(v);
+	return res;
+}
+
+bool script::SetObject::isFlat() const
+{
+	return m_flat;
+}
+
+void script::SetObject::unflatten()
+{
+	if (!m_flat) return;
+
+	m_objects.reserve(m_ints.size());
+	for (int v : m_ints)
+		m_objects.insert(makeInt(v));
+	m_ints.clear();
+	m_ints.shrink_to_fit();
+	m_flat = false;
+}
+
+bool script::SetObject::getInt(const ScriptObjectPtr& value, int& result)
+{
+	const auto i = dynamic_cast<IntObject*>(value.get());
+	if (i == nullptr) return false;
+	result = i->getValue();
+	return true;
+}
+
+script::ScriptObjectPtr script::SetObject::makeInt(int value)
+{
+	return std::make_shared<IntObject>(value);
+}
@@ -1,12 +1,51 @@
 #include "../../../include/script/objects/StringObject.h"
 #include "../../../include/script/Util.h"
+#include "../../../include/script/OutputSink.h"
+#include "../../../include/script/Hash.h"
+#include <algorithm>
 
 script::StringObject::StringObject(std::string value)
 	:
-ValueComparableObject(std::move(value))
+m_tail(std::move(value))
+{
+	if (m_tail.size() >= ChunkSize)
+		seal();
+	setFunctions();
+}
+
+script::StringObject::StringObject(std::shared_ptr<const std::string> value)
+	:
+StringObject(std::make_shared<const Chunk>(value, value->size(), nullptr), std::string(), nullptr)
+{}
+
+script::StringObject::StringObject(std::shared_ptr<const Chunk> chunks, std::string tail, std::shared_ptr<const std::string> flat)
+	:
+m_chunks(move(chunks)),
+m_tail(move(tail)),
+m_flat(move(flat))
+{
+	setFunctions();
+}
+
+script::StringObject::Chunk::Chunk(std::shared_ptr<const std::string> text, size_t length, std::shared_ptr<const Chunk> prev)
+	:
+text(move(text)),
+length(length),
+prev(move(prev))
+{}
+
+script::StringObject::Chunk::~Chunk()
+{
+	auto next = std::move(prev);
+	// a chunk that is only referenced by this chain would be released recursively
+	while (next && next.use_count() == 1)
+		next = std::move(next->prev);
+}
+
+void script::StringObject::setFunctions()
 {
 	addFunction("add", std::bind(&StringObject::add, this, std::placeholders::_1));
-	addFunction("getLength", Util::makeFunction(this, &StringObject::getLength, "int StringObject::getLength()"));
+	addFunction("getLength", Util::makePure(Util::makeFunction(this, &StringObject::getLength, "int StringObject::getLength()")));
 }
 
 script::ScriptObject::FunctionT script::StringObject::getCtor()
@@ -27,12 +66,90 @@ script::ScriptObject::FunctionT script::StringObject::getCtor()
 
 std::string script::StringObject::toString() const
 {
-	return "\"" + m_value + "\"";
+	const auto value = getView();
+	std::string res;
+	res.reserve(value.size() + 2);
+	res += "\"";
+	res += value;
+	res += "\"";
+	return res;
+}
+
+void script::StringObject::writeTo(OutputSink& sink) const
+{
+	sink.write('"');
+	sink.write(getView());
+	sink.write('"');
 }
 
 script::ScriptObjectPtr script::StringObject::clone() const
 {
-	return std::make_shared<StringObject>(m_value);
+	// the chunks are immutable => only the tail is copied
+	return std::shared_ptr<StringObject>(new StringObject(m_chunks, m_tail, m_flat.load()));
+}
+
+bool script::StringObject::equals(const ScriptObjectPtr& other) const
+{
+	auto str = dynamic_cast<StringObject*>(other.get());
+	if (str == nullptr) return false;
+	return getView() == str->getView();
+}
+
+size_t script::StringObject::hashCode() const
+{
+	// an exposed buffer may be modified without notice
+	if (m_exposed)
+		return hash::value(getView());
+
+	auto res = m_hash.load(std::memory_order_relaxed);
+	if (res == NoHash)
+	{
+		// a hash that equals NoHash is computed again next time
+		res = hash::value(getView());
+		m_hash.store(res, std::memory_order_relaxed);
+	}
+	return res;
+}
+
+std::string& script::StringObject::getValue()
+{
+	if (!m_exposed)
+	{
+		// flatten into the tail
+		if (m_chunks)
+		{
+			m_tail = std::string(getView());
+			m_chunks.reset();
+			m_flat.store(nullptr);
+		}
+		m_exposed = true;
+		m_hash.store(NoHash, std::memory_order_relaxed);
+	}
+	return m_tail;
+}
+
+std::string_view script::StringObject::getView() const
+{
+	if (!m_chunks)
+		return m_tail;
+	// single chunk (e.g. an interned literal)
+	if (m_tail.empty() && !m_chunks->prev)
+		return *m_chunks->text;
+
+	auto flat = m_flat.load();
+	if (!flat)
+	{
+		auto res = std::make_shared<std::string>(size(), '\0');
+		std::copy(m_tail.begin(), m_tail.end(), res->end() - m_tail.size());
+		for (auto chunk = m_chunks.get(); chunk; chunk = chunk->prev.get())
+			std::copy(chunk->text->begin(), chunk->text->end(), res->begin() + (chunk->length - chunk->text->size()));
+
+		// another thread may have flattened the string in the meantime => use its result
+		if (!m_flat.compare_exchange_strong(flat, res))
+			return *flat;
+		return *res;
+	}
+	return *flat;
 }
 
 script::ScriptObjectPtr script::StringObject::add(const ArrayObjectPtr& args)
@@ -40,15 +157,42 @@ script::ScriptObjectPtr script::StringObject::add(const ArrayObjectPtr& args)
 	// add all arguments
 	for (const auto& obj : *args)
 	{
-		m_value += Util::getBareString(obj);
+		if (auto str = dynamic_cast<StringObject*>(obj.get()))
+			append(str->getView());
+		else
+			append(Util::getBareString(obj));
 	}
 
 	return shared_from_this();
 }
 
+void script::StringObject::append(std::string_view text)
+{
+	m_hash.store(NoHash, std::memory_order_relaxed);
+	// text may point into the flattened string => reset the flat string afterwards
+	m_tail.append(text.data(), text.size());
+	if (m_chunks)
+		m_flat.store(nullptr);
+
+	if (!m_exposed && m_tail.size() >= ChunkSize)
+		seal();
+}
+
+size_t script::StringObject::size() const
+{
+	return (m_chunks ? m_chunks->length : 0) + m_tail.size();
+}
+
+void script::StringObject::seal()
+{
+	const auto length = size();
+	m_chunks = std::make_shared<const Chunk>(std::make_shared<const std::string>(std::move(m_tail)), length, move(m_chunks));
+	m_tail.clear();
+}
+
 int script::StringObject::getLength() const
 {
-	return int(m_value.length());
+	return int(size());
 }
 
 template<>
@@ -60,4 +204,4 @@ script::ScriptObjectPtr script::Util::makeObject<std::string>(const std::string&
 script::ScriptObjectPtr script::Util::makeObject(const char* text)
 {
 	return std::make_shared<StringObject>(std::string(text));
-}
\ No newline at end of file
+}
@@ -12,7 +12,7 @@ script::ConsoleObject::ConsoleObject()
 		{
 			auto strObj = std::dynamic_pointer_cast<StringObject>(args->get(i));
 			if (strObj)
-				write(strObj->getValue());
+				write(std::string(strObj->getView()));
 			else
 				write(args->get(i)->toString());
 		}
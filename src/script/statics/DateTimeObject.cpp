@@ -1,5 +1,6 @@
 #include "../../../include/script/statics/DateTimeObject.h"
 #include "../../../include/script/Util.h"
+#include "../../../include/script/Hash.h"
 
 script::DateTimeObject::DateTimeObject(std::tm value)
 	:
@@ -25,11 +26,20 @@ script::ScriptObjectPtr script::DateTimeObject::clone() const
 
 bool script::DateTimeObject::equals(const ScriptObjectPtr& other) const
 {
-	auto stamp = std::reinterpret_pointer_cast<DateTimeObject>(other);
+	auto stamp = dynamic_cast<const DateTimeObject*>(other.get());
 	if (!stamp)
 		return false;
 
-	return memcmp(&m_value, &(stamp->m_value), sizeof(m_value)) != 0;
+	return getSecond() == stamp->getSecond() && getMinute() == stamp->getMinute() && getHour() == stamp->getHour() &&
+		getDay() == stamp->getDay() && getMonth() == stamp->getMonth() && getYear() == stamp->getYear();
+}
+
+size_t script::DateTimeObject::hashCode() const
+{
+	size_t res = hash::value(getYear());
+	for (int v : { getMonth(), getDay(), getHour(), getMinute(), getSecond() })
+		res = hash::combine(res, hash::value(v));
+	return res;
 }
 
 int script::DateTimeObject::getSecond() const
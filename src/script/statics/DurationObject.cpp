@@ -14,7 +14,7 @@ ValueComparableObject(value)
 
 std::string script::DurationObject::toString() const
 {
-	return std::to_string(getMilliseconds()) + " ms";
+	return Util::numberToString(getMilliseconds()) + " ms";
 }
 
 script::ScriptObjectPtr script::DurationObject::clone() const
@@ -53,7 +53,7 @@ void script::EngineObject::clearObjects()
 
 std::vector<std::string> script::EngineObject::getObjects() const
 {
-	const auto& objs = m_engine.getObjects();
+	const auto objs = m_engine.getObjects();
 	std::vector<std::string> res;
 	res.reserve(objs.size());
 	for (const auto& o : objs)
@@ -64,10 +64,10 @@ std::vector<std::string> script::EngineObject::getObjects() const
 
 std::vector<std::string> script::EngineObject::getStaticObjects() const
 {
-	const auto& objs = m_engine.getStaticObjects();
+	const auto objs = m_engine.getStaticObjects();
 	std::vector<std::string> res;
-	res.reserve(objs.size());
-	for (const auto& o : objs)
+	res.reserve(objs->size());
+	for (const auto& o : *objs)
 		res.push_back(o.first);
 
 	return res;
@@ -75,10 +75,10 @@ std::vector<std::string> script::EngineObject::getStaticObjects() const
 
 std::vector<std::string> script::EngineObject::getStaticFunctions() const
 {
-	const auto& objs = m_engine.getStaticFunctions();
+	const auto objs = m_engine.getStaticFunctions();
 	std::vector<std::string> res;
-	res.reserve(objs.size());
-	for (const auto& o : objs)
+	res.reserve(objs->size());
+	for (const auto& o : *objs)
 		res.push_back(o.first);
 
 	return res;
@@ -1,7 +1,11 @@
 #include "../../../include/script/statics/IOObject.h"
+#include "../../../include/script/MappedFile.h"
+#include "../../../include/script/StatementReader.h"
+#include "../../../include/script/ScriptImage.h"
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <exception>
 
 script::IOObject::IOObject(ScriptEngine& engine)
 	:
@@ -11,26 +15,24 @@ m_engine(engine)
 	addFunction("writeFile", Util::makeFunction(this, &IOObject::writeFile, "IOObject::writeFile(string filename, string text)"));
 	addFunction("appendFile", Util::makeFunction(this, &IOObject::appendFile, "IOObject::appendFile(string filename, string text)"));
 	addFunction("executeFile", Util::makeFunction(this, &IOObject::executeFile, "IOObject::executeFile(string filename)"));
+	addFunction("compileFile", Util::makeFunction(this, &IOObject::compileFile, "IOObject::compileFile(string scriptFile, string imageFile)"));
+	addFunction("executeImage", Util::makeFunction(this, &IOObject::executeImage, "IOObject::executeImage(string filename)"));
 	addFunction("getExecuteDebugOutput", Util::makeFunction(this, &IOObject::getExecuteDebugOutput, "bool IOObject::getExecuteDebugOutput()"));
 	addFunction("setExecuteDebugOutput", Util::makeFunction(this, &IOObject::setExecuteDebugOutput, "IOObject::setExecuteDebugOutput(bool enable)"));
 }
 
 std::string script::IOObject::readFile(const std::string& filename) const
 {
-	std::ifstream file(filename.c_str());
-	if (!file.is_open())
-		throw std::runtime_error("could not open file " + filename);
-
-	std::string res;
-
-	// allocate enough space
-	file.seekg(0, std::ios::end);
-	res.reserve(size_t(file.tellg()));
-	file.seekg(0, std::ios::beg);
-
-	// read contents
-	res.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
-	
+	const MappedFile file(filename);
+	std::string res(file.getData());
+#ifdef _WIN32
+	// same line endings as a file stream in text mode
+	size_t size = 0;
+	for (size_t i = 0; i < res.size(); ++i)
+		if (res[i] != '\r' || i + 1 == res.size() || res[i + 1] != '\n')
+			res[size++] = res[i];
+	res.resize(size);
+#endif
 	return res;
 }
 
@@ -50,84 +52,107 @@ script::ScriptObjectPtr script::IOObject::executeFile(const std::string& filenam
 	if (m_recursionCounter.getValue() > 50)
 		throw std::runtime_error("recursion level too deep - aborted to prevent stack overflow");
 
-	auto text = readFile(filename);
+	const MappedFile file(filename);
 
 	// output information
 	std::cout << "executing \"" << filename << "\":" << std::endl;
 
-	// read lines and remember line number
-	size_t lineNo = 1;
-	size_t commandStartLine = 0;
-	bool isComment = false;
-	std::string command;
-	command.reserve(128);
+	StatementReader reader(file.getData());
+	std::vector<StatementReader::Statement> statements;
+	std::vector<ScriptEngine::CompiledCommand> compiled;
+	// syntax errors of the statements
+	std::vector<std::exception_ptr> errors;
 	ScriptObjectPtr lastObject = NullObject::get();
-
-	for(auto c = text.begin(), end = text.end(); c != end; ++c)
+	while (reader.read(statements, ChunkSize))
 	{
-		// new line
-		if (*c == '\n')
-		{
-			lineNo++;
-			isComment = false;
-		}
-
-		// ignore values in comments
-		if (isComment) continue;
-
-		// start the command with the first non whitespace character
-		if(command.empty() && isspace(*c))
-			continue;
-
-		// line number should be number of first character
-		if (command.empty())
-			commandStartLine = lineNo;
-
-		switch (*c)
+		// compile the chunk before the first statement is executed
+		compiled.assign(statements.size(), ScriptEngine::CompiledCommand());
+		errors.assign(statements.size(), nullptr);
+		m_engine.getThreadPool().parallelFor(statements.size(), CompileGrainSize, [&](size_t begin, size_t end)
 		{
-		case '\\':
-			// some escape character => ignore and skip character
-			command += *c;
-			if ((c + 1) != end)
+			for (auto i = begin; i < end; ++i)
 			{
-				++c;
-				command += *c;
+				try
+				{
+					// views into the mapping (or the statement copy) that stay valid until the next chunk is read
+					compiled[i] = m_engine.compile(statements[i].getCommand(), false);
+				}
+				catch (...)
+				{
+					errors[i] = std::current_exception();
+				}
 			}
-			continue;
-		case ';':
-			// end of command
+		});
+
+		for (size_t i = 0; i < statements.size(); ++i)
+		{
 			try
 			{
 				if(m_executeDebugOutput)
-					std::cout << "line " << commandStartLine << ": " << command << std::endl;
+					std::cout << "line " << statements[i].line << ": " << statements[i].getCommand() << std::endl;
 
-				lastObject = m_engine.execute(command);
+				// syntax errors are reported when the statement is reached
+				if (errors[i])
+					std::rethrow_exception(errors[i]);
+				lastObject = m_engine.execute(compiled[i]);
 			}
-			catch (std::exception& e)
+			catch (const ExecutionAbortedException&)
 			{
-				throw std::runtime_error(filename + " line " + std::to_string(commandStartLine) + std::string(": ") + e.what());
+				throw;
 			}
-			command.resize(0);
-			continue;
-		case '/':
-			// comment start?
-			if((c + 1) != end && *(c + 1) == '/')
+			catch (std::exception& e)
 			{
-				isComment = true;
-				continue;
+				throw std::runtime_error(filename + " line " + std::to_string(statements[i].line) + std::string(": ") + e.what());
 			}
-			break;
 		}
-		
-		command += *c;
 	}
 
-	if (!command.empty())
+	if (reader.hasRemainder())
 		throw std::runtime_error(filename + " missing ; at the end of the file");
 
 	return lastObject;
 }
 
+void script::IOObject::compileFile(const std::string& scriptFile, const std::string& imageFile) const
+{
+	ScriptImage::compileFile(m_engine, scriptFile, imageFile);
+}
+
+script::ScriptObjectPtr script::IOObject::executeImage(const std::string& filename)
+{
+	std::lock_guard<IntMutex> recCounter(m_recursionCounter);
+	if (m_recursionCounter.getValue() > 50)
+		throw std::runtime_error("recursion level too deep - aborted to prevent stack overflow");
+
+	const ScriptImage image(filename, m_engine);
+
+	// output information
+	std::cout << "executing \"" << filename << "\":" << std::endl;
+
+	ScriptObjectPtr lastObject = NullObject::get();
+	for (size_t i = 0; i < image.getStatementCount(); ++i)
+	{
+		try
+		{
+			const auto command = image.getCommand(i, m_engine);
+			if(m_executeDebugOutput)
+				std::cout << "line " << image.getLine(i) << ": " << command.text << std::endl;
+
+			lastObject = m_engine.execute(command);
+		}
+		catch (const ExecutionAbortedException&)
+		{
+			throw;
+		}
+		catch (std::exception& e)
+		{
+			throw std::runtime_error(filename + " line " + std::to_string(image.getLine(i)) + std::string(": ") + e.what());
+		}
+	}
+
+	return lastObject;
+}
+
 void script::IOObject::setExecuteDebugOutput(bool enable)
 {
 	m_executeDebugOutput = enable;
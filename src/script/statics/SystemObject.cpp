@@ -1,11 +1,18 @@
 #include "../../../include/script/statics/SystemObject.h"
+#include "../../../include/script/ResumableScript.h"
 
 script::SystemObject::SystemObject()
 {
 	addFunction("silent", Util::makeFunction(this, &SystemObject::silent, "null SystemObject::silent()"));
+	addFunction("yield", Util::makeFunction(this, &SystemObject::yield, "bool SystemObject::yield()"));
 }
 
 script::ScriptObjectPtr script::SystemObject::silent(const ScriptObjectPtr&) const
 {
 	return NullObject::get();
 }
+
+bool script::SystemObject::yield() const
+{
+	return ResumableScript::yield();
+}
\ No newline at end of file
@@ -15,7 +15,7 @@ ValueComparableObject(time)
 std::string script::TimestampObject::toString() const
 {
 	auto dur = m_value.time_since_epoch();
-	return "Timestamp(" + std::to_string(dur.count()) + ")";
+	return "Timestamp(" + Util::numberToString(dur.count()) + ")";
 }
 
 script::ScriptObjectPtr script::TimestampObject::clone() const
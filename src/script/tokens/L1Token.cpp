@@ -1,5 +1,6 @@
 #include "../../../include/script/tokens/L1Token.h"
 #include "../../../include/script/Exception.h"
+#include "../../../include/script/Util.h"
 #include <algorithm>
 
 script::L1Token::L1Token(Type type, size_t position, std::string value)
@@ -63,7 +64,7 @@ bool script::L1Token::startWithUppercase() const
 int script::L1Token::getIntValue() const
 try
 {
-	return std::stoi(m_value);
+	return Util::parseNumber<int>(m_value);
 }
 catch (const std::exception&)
 {
@@ -73,7 +74,7 @@ catch (const std::exception&)
 float script::L1Token::getFloatValue() const
 try
 {
-	return std::stof(m_value);
+	return Util::parseNumber<float>(m_value);
 }
 catch (const std::exception&)
 {
@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2ArgumentListToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::ScriptObjectPtr script::L2ArgumentListToken::execute(ScriptEngine& engine) const
 {
@@ -13,4 +14,13 @@ script::ScriptObjectPtr script::L2ArgumentListToken::execute(ScriptEngine& engin
 void script::L2ArgumentListToken::add(std::unique_ptr<L2Token> value)
 {
 	m_values.emplace_back(move(value));
+}
+
+uint32_t script::L2ArgumentListToken::write(ScriptImageWriter& writer) const
+{
+	std::vector<uint32_t> values;
+	values.reserve(m_values.size());
+	for (const auto& v : m_values)
+		values.push_back(writer.add(v.get()));
+	return writer.addNode(image::NodeType::ArgumentList, 0, writer.addList(values), uint32_t(values.size()));
 }
\ No newline at end of file
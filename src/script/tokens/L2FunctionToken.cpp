@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2FunctionToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2FunctionToken::L2FunctionToken(std::unique_ptr<L2Token> value, std::string name, size_t position,
 	std::unique_ptr<L2Token> args) :
@@ -15,6 +16,7 @@ script::ScriptObjectPtr script::L2FunctionToken::execute(ScriptEngine& engine) c
 	auto obj = m_value->execute(engine);
 
 	// call function on value
+	engine.step();
 	try
 	{
 		obj = obj->invoke(m_funcName, args);
@@ -24,6 +26,10 @@ script::ScriptObjectPtr script::L2FunctionToken::execute(ScriptEngine& engine) c
 		// add line number information
 		throw ParseError(m_position, e.what());
 	}
+	catch (const ExecutionAbortedException&)
+	{
+		throw;
+	}
 	catch (const std::exception& e)
 	{
 		// add line number information
@@ -31,4 +37,11 @@ script::ScriptObjectPtr script::L2FunctionToken::execute(ScriptEngine& engine) c
 	}
 
 	return obj;
+}
+
+uint32_t script::L2FunctionToken::write(ScriptImageWriter& writer) const
+{
+	const auto value = writer.add(m_value.get());
+	const auto args = writer.add(m_args.get());
+	return writer.addNode(image::NodeType::Function, m_position, value, writer.addString(m_funcName), args);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2IdentifierAssignToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2IdentifierAssignToken::L2IdentifierAssignToken(std::string name, std::unique_ptr<L2Token> value) :
 	m_name(move(name)),
@@ -11,4 +12,10 @@ script::ScriptObjectPtr script::L2IdentifierAssignToken::execute(ScriptEngine& e
 	auto obj = m_value->execute(engine);
 	engine.setObject(m_name, obj);
 	return obj;
+}
+
+uint32_t script::L2IdentifierAssignToken::write(ScriptImageWriter& writer) const
+{
+	const auto value = writer.add(m_value.get());
+	return writer.addNode(image::NodeType::IdentifierAssign, 0, writer.addString(m_name), value);
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2IdentifierToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2IdentifierToken::L2IdentifierToken(std::string name, size_t position)
 	:
@@ -14,4 +15,9 @@ script::ScriptObjectPtr script::L2IdentifierToken::execute(ScriptEngine& engine)
 		throw IdentifierError(m_position, m_name);
 
 	return obj;
+}
+
+uint32_t script::L2IdentifierToken::write(ScriptImageWriter& writer) const
+{
+	return writer.addNode(image::NodeType::Identifier, m_position, writer.addString(m_name));
 }
\ No newline at end of file
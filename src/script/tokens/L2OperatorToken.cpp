@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2OperatorToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2OperatorToken::L2OperatorToken(std::unique_ptr<L2Token> left, std::unique_ptr<L2Token> right, size_t position,
 	std::string funcName, bool clone, std::string opSign) :
@@ -34,6 +35,7 @@ script::ScriptObjectPtr script::L2OperatorToken::execute(ScriptEngine& engine) c
 	}
 
 	// call the appropriate function
+	engine.step();
 	if (m_right) // binary operator
 	{
 		try
@@ -48,6 +50,10 @@ script::ScriptObjectPtr script::L2OperatorToken::execute(ScriptEngine& engine) c
 				"object requires a " + m_funcName + "(object) function to use the binary \"" + m_opSign +
 				"\" operator");
 		}
+		catch (const ExecutionAbortedException&)
+		{
+			throw;
+		}
 		catch (const std::exception& e)
 		{
 			// add line number information
@@ -67,6 +73,10 @@ script::ScriptObjectPtr script::L2OperatorToken::execute(ScriptEngine& engine) c
 				m_position,
 				"object requires a " + m_funcName + "() function to use the unary \"" + m_opSign + "\" operator");
 		}
+		catch (const ExecutionAbortedException&)
+		{
+			throw;
+		}
 		catch (const std::exception& e)
 		{
 			// add line number information
@@ -76,3 +86,11 @@ script::ScriptObjectPtr script::L2OperatorToken::execute(ScriptEngine& engine) c
 
 	return left;
 }
+
+uint32_t script::L2OperatorToken::write(ScriptImageWriter& writer) const
+{
+	const auto left = writer.add(m_left.get());
+	const auto right = writer.add(m_right.get());
+	return writer.addNode(image::NodeType::Operator, m_position, left, right,
+		writer.addString(m_funcName), writer.addString(m_opSign), m_clone);
+}
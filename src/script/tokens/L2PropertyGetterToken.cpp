@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2PropertyGetterToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2PropertyGetterToken::L2PropertyGetterToken(std::unique_ptr<L2Token> object, std::string propName,
 	size_t position) :
@@ -20,10 +21,20 @@ script::ScriptObjectPtr script::L2PropertyGetterToken::execute(ScriptEngine& eng
 		// add line number information
 		throw ParseError(m_position, "property getter " + m_funcName + " not found");
 	}
+	catch (const ExecutionAbortedException&)
+	{
+		throw;
+	}
 	catch (const std::exception& e)
 	{
 		// add line number information
 		throw ParseError(m_position, "get" + m_funcName + " exception: " + std::string(e.what()));
 	}
 	return obj;
+}
+
+uint32_t script::L2PropertyGetterToken::write(ScriptImageWriter& writer) const
+{
+	const auto object = writer.add(m_object.get());
+	return writer.addNode(image::NodeType::PropertyGetter, m_position, object, writer.addString(m_funcName));
 }
\ No newline at end of file
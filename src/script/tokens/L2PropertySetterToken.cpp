@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2PropertySetterToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2PropertySetterToken::L2PropertySetterToken(std::unique_ptr<L2Token> object, std::unique_ptr<L2Token> arg,
 	std::string propName, size_t position) :
@@ -22,10 +23,21 @@ script::ScriptObjectPtr script::L2PropertySetterToken::execute(ScriptEngine& eng
 		// add line number information
 		throw ParseError(m_position, "property setter " + m_funcName + " not found");
 	}
+	catch (const ExecutionAbortedException&)
+	{
+		throw;
+	}
 	catch (const std::exception& e)
 	{
 		// add line number information
 		throw ParseError(m_position, "set" + m_funcName + " exception: " + std::string(e.what()));
 	}
 	return obj;
+}
+
+uint32_t script::L2PropertySetterToken::write(ScriptImageWriter& writer) const
+{
+	const auto object = writer.add(m_object.get());
+	const auto arg = writer.add(m_arg.get());
+	return writer.addNode(image::NodeType::PropertySetter, m_position, object, arg, writer.addString(m_funcName));
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2StaticFunctionToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2StaticFunctionToken::L2StaticFunctionToken(std::string name, size_t position, std::unique_ptr<L2Token> args) 
 	:
@@ -19,13 +20,24 @@ script::ScriptObjectPtr script::L2StaticFunctionToken::execute(ScriptEngine& eng
 	const auto args = std::dynamic_pointer_cast<ArrayObject>(m_args->execute(engine));
 
 	// call function
+	engine.step();
 	try
 	{
 		return func(args);
 	}
+	catch (const ExecutionAbortedException&)
+	{
+		throw;
+	}
 	catch (const std::exception& e)
 	{
 		// add line number information
 		throw ParseError(m_position, m_funcName + "(...) exception: " + std::string(e.what()));
 	}
 }
+
+uint32_t script::L2StaticFunctionToken::write(ScriptImageWriter& writer) const
+{
+	const auto args = writer.add(m_args.get());
+	return writer.addNode(image::NodeType::StaticFunction, m_position, writer.addString(m_funcName), args);
+}
@@ -1,4 +1,5 @@
 #include "../../../include/script/tokens/L2StaticIdentifierToken.h"
+#include "../../../include/script/ScriptImage.h"
 
 script::L2StaticIdentifierToken::L2StaticIdentifierToken(std::string name, size_t position)
 	:
@@ -14,4 +15,9 @@ script::ScriptObjectPtr script::L2StaticIdentifierToken::execute(ScriptEngine& e
 		throw IdentifierError(m_position, m_name);
 
 	return obj;
+}
+
+uint32_t script::L2StaticIdentifierToken::write(ScriptImageWriter& writer) const
+{
+	return writer.addNode(image::NodeType::StaticIdentifier, m_position, writer.addString(m_name));
 }
\ No newline at end of file